@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+#include "allocation_counter.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+std::atomic<std::size_t> allocations{};
+std::atomic<std::size_t> bytes{};
+
+[[nodiscard]]
+void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    size = size == 0 ? 1 : size;
+    void* pointer = alignment <= alignof(std::max_align_t)
+        ? std::malloc(size)
+        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!pointer){
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+} /* namespace */
+
+std::size_t allocation_count() noexcept
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t allocated_bytes() noexcept
+{
+    return bytes.load(std::memory_order_relaxed);
+}
+
+} /* namespace recognition::benchmarks */
+
+void* operator new(std::size_t size)
+{
+    return recognition::benchmarks::allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return recognition::benchmarks::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
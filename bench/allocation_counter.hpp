@@ -0,0 +1,28 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+namespace recognition::benchmarks {
+
+/**
+ * @brief Get the number of the allocations made by the global operator new of the process.
+ *
+ * @note The benchmarks replace the global operator new and delete, so the allocations
+ *       of libmagicxx are counted too, the allocations of libmagic (malloc) are not.
+ */
+[[nodiscard]]
+std::size_t allocation_count() noexcept;
+
+/**
+ * @brief Get the number of the bytes allocated by the global operator new of the process.
+ */
+[[nodiscard]]
+std::size_t allocated_bytes() noexcept;
+
+} /* namespace recognition::benchmarks */
+
+#endif /* ALLOCATION_COUNTER_HPP */
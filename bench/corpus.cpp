@@ -0,0 +1,644 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <span>
+#include <format>
+#include <random>
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include "corpus.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+using bytes_t = std::string;
+
+/**
+ * @brief The generator class generates the deterministic contents of the files.
+ *
+ * @note Only the raw output of std::mt19937_64 is used, which is specified by the
+ *       standard, unlike the standard distributions.
+ */
+class generator {
+public:
+    explicit generator(std::uint64_t seed)
+        : m_engine{seed}
+    { }
+
+    [[nodiscard]]
+    std::size_t below(std::size_t bound)
+    {
+        return static_cast<std::size_t>(m_engine() % bound);
+    }
+
+    void append_bytes(bytes_t& bytes, std::size_t count)
+    {
+        for (std::size_t i{}; i < count; ++i){
+            bytes.push_back(static_cast<char>(m_engine() & 0xff));
+        }
+    }
+
+    void append_words(bytes_t& text, std::size_t size, std::span<const std::string_view> words)
+    {
+        std::size_t line_length{};
+        while (true){
+            const auto word = words[below(words.size())];
+            if (text.size() + word.size() + 1 >= size){
+                break;
+            }
+            text += word;
+            line_length += word.size() + 1;
+            if (line_length > 72){
+                text += '\n';
+                line_length = 0;
+            } else {
+                text += ' ';
+            }
+        }
+        while (text.size() + 1 < size){
+            text += ' ';
+        }
+        text += '\n';
+    }
+
+private:
+    std::mt19937_64 m_engine;
+};
+
+constexpr std::array<std::string_view, 20> ascii_words{
+    "the", "quick", "magic", "number", "recognition", "library", "file", "type", "data", "buffer",
+    "database", "pattern", "offset", "string", "value", "test", "search", "result", "format", "text"
+};
+
+constexpr std::array<std::string_view, 20> utf8_words{
+    "the", "magic", "number", "file", "type", "data", "text", "value", "search", "result",
+    "çağrı", "öğrenci", "Straße", "naïve", "café", "日本語", "文字列", "Ελληνικά", "русский", "mañana"
+};
+
+constexpr std::array<std::string_view, 20> latin1_words{
+    "the", "magic", "number", "file", "type", "data", "text", "value", "search", "result",
+    "caf\xe9", "ma\xf1" "ana", "gr\xfc\xdf" "e", "na\xefve", "\xe9t\xe9", "fran\xe7" "ais", "s\xf8ster", "\xe5r", "\xfc" "ber", "d\xe9j\xe0"
+};
+
+[[nodiscard]]
+std::uint32_t crc32(std::string_view bytes, std::uint32_t crc = 0)
+{
+    static const auto table = []{
+        std::array<std::uint32_t, 256> crc_table{};
+        for (std::uint32_t i{}; i < crc_table.size(); ++i){
+            auto value = i;
+            for (int bit{}; bit < 8; ++bit){
+                value = (value & 1) ? 0xedb88320U ^ (value >> 1) : value >> 1;
+            }
+            crc_table[i] = value;
+        }
+        return crc_table;
+    }();
+    crc = ~crc;
+    for (auto byte : bytes){
+        crc = table[(crc ^ static_cast<unsigned char>(byte)) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+template <std::size_t Width>
+void append_le(bytes_t& bytes, std::uint64_t value)
+{
+    for (std::size_t i{}; i < Width; ++i){
+        bytes.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+template <std::size_t Width>
+void append_be(bytes_t& bytes, std::uint64_t value)
+{
+    for (std::size_t i{Width}; i > 0; --i){
+        bytes.push_back(static_cast<char>((value >> ((i - 1) * 8)) & 0xff));
+    }
+}
+
+[[nodiscard]]
+bytes_t ascii_text(generator& g, std::size_t size)
+{
+    bytes_t text;
+    g.append_words(text, size, ascii_words);
+    return text;
+}
+
+[[nodiscard]]
+bytes_t utf8_text(generator& g, std::size_t size)
+{
+    bytes_t text;
+    g.append_words(text, size, utf8_words);
+    return text;
+}
+
+[[nodiscard]]
+bytes_t utf8_bom_text(generator& g, std::size_t size)
+{
+    bytes_t text{"\xef\xbb\xbf"};
+    g.append_words(text, size, utf8_words);
+    return text;
+}
+
+[[nodiscard]]
+bytes_t utf16le_text(generator& g, std::size_t size)
+{
+    bytes_t text{"\xff\xfe"};
+    for (auto character : ascii_text(g, size / 2 - 1)){
+        text += character;
+        text += '\0';
+    }
+    return text;
+}
+
+[[nodiscard]]
+bytes_t latin1_text(generator& g, std::size_t size)
+{
+    bytes_t text;
+    g.append_words(text, size, latin1_words);
+    return text;
+}
+
+[[nodiscard]]
+bytes_t c_source(generator& g, std::size_t size)
+{
+    bytes_t text{"#include <stdio.h>\n\n"};
+    const bytes_t tail{"int main(void)\n{\n    printf(\"%d\\n\", function_0(1));\n    return 0;\n}\n"};
+    for (std::size_t i{}; ; ++i){
+        auto function = std::format(
+            "static int function_{}(int value)\n{{\n    return value * {} + {};\n}}\n\n",
+            i, g.below(1000), g.below(1000)
+        );
+        if (text.size() + function.size() + tail.size() > size && i > 0){
+            break;
+        }
+        text += function;
+    }
+    return text + tail;
+}
+
+[[nodiscard]]
+bytes_t shell_script(generator& g, std::size_t size)
+{
+    bytes_t text{"#!/bin/sh\n\n"};
+    while (true){
+        bytes_t line{"echo \""};
+        g.append_words(line, 40, ascii_words);
+        line.pop_back();
+        line += "\"\n";
+        if (text.size() + line.size() > size){
+            break;
+        }
+        text += line;
+    }
+    return text;
+}
+
+[[nodiscard]]
+bytes_t json_text(generator& g, std::size_t size)
+{
+    bytes_t text{"[\n"};
+    for (std::size_t i{}; ; ++i){
+        auto item = std::format(
+            "{}  {{\"id\": {}, \"name\": \"{}\", \"value\": {}}}",
+            i > 0 ? ",\n" : "", i, ascii_words[g.below(ascii_words.size())], g.below(100000)
+        );
+        if (text.size() + item.size() + 3 > size && i > 0){
+            break;
+        }
+        text += item;
+    }
+    return text + "\n]\n";
+}
+
+[[nodiscard]]
+bytes_t csv_text(generator& g, std::size_t size)
+{
+    bytes_t text{"id,name,value,description\n"};
+    for (std::size_t i{}; ; ++i){
+        auto row = std::format(
+            "{},{},{},{} {}\n", i,
+            ascii_words[g.below(ascii_words.size())], g.below(100000),
+            ascii_words[g.below(ascii_words.size())], ascii_words[g.below(ascii_words.size())]
+        );
+        if (text.size() + row.size() > size && i > 0){
+            break;
+        }
+        text += row;
+    }
+    return text;
+}
+
+[[nodiscard]]
+bytes_t html_text(generator& g, std::size_t size)
+{
+    bytes_t text{"<!DOCTYPE html>\n<html>\n<head>\n<title>magicxx</title>\n</head>\n<body>\n"};
+    const bytes_t tail{"</body>\n</html>\n"};
+    while (true){
+        bytes_t paragraph{"<p>"};
+        g.append_words(paragraph, 80, ascii_words);
+        paragraph.pop_back();
+        paragraph += "</p>\n";
+        if (text.size() + paragraph.size() + tail.size() > size){
+            break;
+        }
+        text += paragraph;
+    }
+    return text + tail;
+}
+
+[[nodiscard]]
+bytes_t xml_text(generator& g, std::size_t size)
+{
+    bytes_t text{"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<corpus>\n"};
+    const bytes_t tail{"</corpus>\n"};
+    for (std::size_t i{}; ; ++i){
+        bytes_t item{std::format("  <item id=\"{}\">", i)};
+        g.append_words(item, item.size() + 60, ascii_words);
+        item.pop_back();
+        item += "</item>\n";
+        if (text.size() + item.size() + tail.size() > size && i > 0){
+            break;
+        }
+        text += item;
+    }
+    return text + tail;
+}
+
+void append_png_chunk(bytes_t& bytes, std::string_view type, std::string_view data)
+{
+    append_be<4>(bytes, data.size());
+    const auto chunk = bytes_t{type} + bytes_t{data};
+    bytes += chunk;
+    append_be<4>(bytes, crc32(chunk));
+}
+
+[[nodiscard]]
+bytes_t png_image(generator& g, std::size_t size)
+{
+    bytes_t bytes{"\x89PNG\r\n\x1a\n"};
+    bytes_t header;
+    append_be<4>(header, g.below(4096) + 1);
+    append_be<4>(header, g.below(4096) + 1);
+    header += std::string_view{"\x08\x02\x00\x00\x00", 5};
+    append_png_chunk(bytes, "IHDR", header);
+    bytes_t data;
+    g.append_bytes(data, size > 57 ? size - 57 : 0);
+    append_png_chunk(bytes, "IDAT", data);
+    append_png_chunk(bytes, "IEND", {});
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t gif_image(generator& g, std::size_t size)
+{
+    bytes_t bytes{"GIF89a"};
+    append_le<2>(bytes, g.below(4096) + 1);
+    append_le<2>(bytes, g.below(4096) + 1);
+    bytes += std::string_view{"\xf7\x00\x00", 3};
+    g.append_bytes(bytes, size - bytes.size() - 1);
+    return bytes + ";";
+}
+
+[[nodiscard]]
+bytes_t jpeg_image(generator& g, std::size_t size)
+{
+    bytes_t bytes{"\xff\xd8\xff\xe0\x00\x10JFIF\x00\x01\x01\x00\x00\x01\x00\x01\x00\x00", 20};
+    g.append_bytes(bytes, size - bytes.size() - 2);
+    return bytes + "\xff\xd9";
+}
+
+[[nodiscard]]
+bytes_t pdf_document(generator& g, std::size_t size)
+{
+    bytes_t bytes{"%PDF-1.4\n%\xe2\xe3\xcf\xd3\n"};
+    const bytes_t tail{"trailer\n<< /Root 1 0 R >>\n%%EOF\n"};
+    for (std::size_t i{1}; ; ++i){
+        bytes_t stream;
+        g.append_bytes(stream, 256 + g.below(4096));
+        auto object = std::format("{} 0 obj\n<< /Length {} >>\nstream\n{}\nendstream\nendobj\n", i, stream.size(), stream);
+        if (bytes.size() + object.size() + tail.size() > size && i > 1){
+            break;
+        }
+        bytes += object;
+    }
+    return bytes + tail;
+}
+
+[[nodiscard]]
+bytes_t elf_executable(generator& g, std::size_t size)
+{
+    bytes_t bytes{"\x7f" "ELF\x02\x01\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00", 16};
+    append_le<2>(bytes, 2);
+    append_le<2>(bytes, 62);
+    append_le<4>(bytes, 1);
+    append_le<8>(bytes, 0x401000);
+    append_le<8>(bytes, 0);
+    append_le<8>(bytes, 0);
+    append_le<4>(bytes, 0);
+    append_le<2>(bytes, 64);
+    append_le<2>(bytes, 56);
+    append_le<2>(bytes, 0);
+    append_le<2>(bytes, 64);
+    append_le<2>(bytes, 0);
+    append_le<2>(bytes, 0);
+    g.append_bytes(bytes, size - bytes.size());
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t sqlite_database(generator& g, std::size_t size)
+{
+    bytes_t bytes{"SQLite format 3", 16};
+    append_be<2>(bytes, 4096);
+    bytes += std::string_view{"\x01\x01\x00\x40\x20\x20", 6};
+    append_be<4>(bytes, 1);
+    append_be<4>(bytes, std::max(size / 4096, 1uz));
+    bytes.resize(100, '\0');
+    g.append_bytes(bytes, size - bytes.size());
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t wave_audio(generator& g, std::size_t size)
+{
+    const auto data_size = size - 44;
+    bytes_t bytes{"RIFF"};
+    append_le<4>(bytes, size - 8);
+    bytes += "WAVEfmt ";
+    append_le<4>(bytes, 16);
+    append_le<2>(bytes, 1);
+    append_le<2>(bytes, 2);
+    append_le<4>(bytes, 44100);
+    append_le<4>(bytes, 44100 * 4);
+    append_le<2>(bytes, 4);
+    append_le<2>(bytes, 16);
+    bytes += "data";
+    append_le<4>(bytes, data_size);
+    g.append_bytes(bytes, data_size);
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t random_data(generator& g, std::size_t size)
+{
+    bytes_t bytes;
+    g.append_bytes(bytes, size);
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t zip_archive(generator& g, std::size_t size)
+{
+    const std::string_view name{"corpus/data.txt"};
+    const auto data = ascii_text(g, size);
+    const auto crc = crc32(data);
+    auto append_entry = [&](bytes_t& bytes, bool central){
+        bytes += central ? std::string_view{"PK\x01\x02\x14\x00", 6} : std::string_view{"PK\x03\x04", 4};
+        append_le<2>(bytes, 20);
+        append_le<2>(bytes, 0);
+        append_le<2>(bytes, 0);
+        append_le<2>(bytes, 0);
+        append_le<2>(bytes, 0x21);
+        append_le<4>(bytes, crc);
+        append_le<4>(bytes, data.size());
+        append_le<4>(bytes, data.size());
+        append_le<2>(bytes, name.size());
+        append_le<2>(bytes, 0);
+        if (central){
+            append_le<2>(bytes, 0);
+            append_le<2>(bytes, 0);
+            append_le<2>(bytes, 0);
+            append_le<4>(bytes, 0);
+            append_le<4>(bytes, 0);
+        }
+        bytes += name;
+    };
+    bytes_t bytes;
+    append_entry(bytes, false);
+    bytes += data;
+    const auto central_directory_offset = bytes.size();
+    append_entry(bytes, true);
+    const auto central_directory_size = bytes.size() - central_directory_offset;
+    bytes += std::string_view{"PK\x05\x06\x00\x00\x00\x00\x01\x00\x01\x00", 12};
+    append_le<4>(bytes, central_directory_size);
+    append_le<4>(bytes, central_directory_offset);
+    append_le<2>(bytes, 0);
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t tar_archive(generator& g, std::size_t size)
+{
+    const auto data = ascii_text(g, size);
+    bytes_t header(512, '\0');
+    auto set_field = [&header](std::size_t offset, std::string_view value){
+        std::ranges::copy(value, header.begin() + static_cast<std::ptrdiff_t>(offset));
+    };
+    set_field(0, "corpus/data.txt");
+    set_field(100, "0000644");
+    set_field(108, "0001750");
+    set_field(116, "0001750");
+    set_field(124, std::format("{:011o}", data.size()));
+    set_field(136, "00000000000");
+    set_field(148, "        ");
+    set_field(156, "0");
+    set_field(257, std::string_view{"ustar\x00" "00", 8});
+    set_field(265, "magicxx");
+    set_field(297, "magicxx");
+    const auto checksum = std::accumulate(header.begin(), header.end(), 0U, [](auto sum, char byte){
+        return sum + static_cast<unsigned char>(byte);
+    });
+    set_field(148, std::format("{:06o}", checksum));
+    header[154] = '\0';
+    bytes_t bytes{header + data};
+    bytes.resize((bytes.size() + 511) / 512 * 512 + 1024, '\0');
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t gzip_compress(std::string_view data)
+{
+    bytes_t bytes{"\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03", 10};
+    constexpr std::size_t max_block_size = 65535;
+    std::size_t offset{};
+    do {
+        const auto block = data.substr(offset, max_block_size);
+        offset += block.size();
+        bytes += static_cast<char>(offset == data.size() ? 1 : 0);
+        append_le<2>(bytes, block.size());
+        append_le<2>(bytes, ~block.size() & 0xffff);
+        bytes += block;
+    } while (offset < data.size());
+    append_le<4>(bytes, crc32(data));
+    append_le<4>(bytes, data.size() & 0xffffffff);
+    return bytes;
+}
+
+[[nodiscard]]
+bytes_t gzip_text(generator& g, std::size_t size)
+{
+    return gzip_compress(ascii_text(g, size));
+}
+
+[[nodiscard]]
+bytes_t gzip_tar_archive(generator& g, std::size_t size)
+{
+    return gzip_compress(tar_archive(g, size));
+}
+
+[[nodiscard]]
+bytes_t zstd_text(generator& g, std::size_t size)
+{
+    const auto data = ascii_text(g, size);
+    bytes_t bytes{"\x28\xb5\x2f\xfd\x00\x38", 6};
+    constexpr std::size_t max_block_size = 128 * 1024;
+    for (std::size_t offset{}; offset < data.size(); offset += max_block_size){
+        const auto block = std::string_view{data}.substr(offset, max_block_size);
+        const bool last = offset + block.size() >= data.size();
+        append_le<3>(bytes, (block.size() << 3) | (last ? 1 : 0));
+        bytes += block;
+    }
+    return bytes;
+}
+
+struct format_t {
+    std::string_view name;
+    std::string_view extension;
+    corpus::category kind;
+    bytes_t (*generate)(generator&, std::size_t);
+};
+
+constexpr std::array formats{
+    format_t{"png",        "png",     corpus::category::binary,     png_image},
+    format_t{"gif",        "gif",     corpus::category::binary,     gif_image},
+    format_t{"jpeg",       "jpg",     corpus::category::binary,     jpeg_image},
+    format_t{"pdf",        "pdf",     corpus::category::binary,     pdf_document},
+    format_t{"elf",        "elf",     corpus::category::binary,     elf_executable},
+    format_t{"sqlite",     "sqlite",  corpus::category::binary,     sqlite_database},
+    format_t{"wave",       "wav",     corpus::category::binary,     wave_audio},
+    format_t{"zip",        "zip",     corpus::category::binary,     zip_archive},
+    format_t{"tar",        "tar",     corpus::category::binary,     tar_archive},
+    format_t{"data",       "bin",     corpus::category::binary,     random_data},
+    format_t{"ascii",      "txt",     corpus::category::text,       ascii_text},
+    format_t{"utf8",       "txt",     corpus::category::text,       utf8_text},
+    format_t{"utf8_bom",   "txt",     corpus::category::text,       utf8_bom_text},
+    format_t{"utf16le",    "txt",     corpus::category::text,       utf16le_text},
+    format_t{"latin1",     "txt",     corpus::category::text,       latin1_text},
+    format_t{"c",          "c",       corpus::category::text,       c_source},
+    format_t{"shell",      "sh",      corpus::category::text,       shell_script},
+    format_t{"json",       "json",    corpus::category::text,       json_text},
+    format_t{"csv",        "csv",     corpus::category::text,       csv_text},
+    format_t{"html",       "html",    corpus::category::text,       html_text},
+    format_t{"xml",        "xml",     corpus::category::text,       xml_text},
+    format_t{"gzip",       "gz",      corpus::category::compressed, gzip_text},
+    format_t{"gzip_tar",   "tar.gz",  corpus::category::compressed, gzip_tar_archive},
+    format_t{"zstd",       "zst",     corpus::category::compressed, zstd_text}
+};
+
+[[nodiscard]]
+std::uint64_t seed(std::string_view name) noexcept
+{
+    std::uint64_t value{0xcbf29ce484222325ULL};
+    for (auto byte : name){
+        value = (value ^ static_cast<unsigned char>(byte)) * 0x100000001b3ULL;
+    }
+    return value;
+}
+
+} /* namespace */
+
+corpus::corpus(std::filesystem::path directory)
+    : m_directory{std::move(directory)}
+{
+    generate();
+}
+
+const std::filesystem::path& corpus::directory() const noexcept
+{
+    return m_directory;
+}
+
+const std::vector<corpus::file_t>& corpus::files() const noexcept
+{
+    return m_files;
+}
+
+const corpus::file_t& corpus::get(std::string_view format, std::size_t size) const
+{
+    const auto prefix = std::format("{}_{}.", format, size);
+    auto file = std::ranges::find_if(m_files, [&prefix](const auto& corpus_file){
+        return corpus_file.path.filename().string().starts_with(prefix);
+    });
+    if (file == m_files.end()){
+        throw std::out_of_range{std::format("no {} file of {} bytes in the corpus", format, size)};
+    }
+    return *file;
+}
+
+std::vector<std::filesystem::path> corpus::paths() const
+{
+    std::vector<std::filesystem::path> file_paths;
+    std::ranges::transform(m_files, std::back_inserter(file_paths), &file_t::path);
+    return file_paths;
+}
+
+std::vector<std::filesystem::path> corpus::paths(category kind) const
+{
+    std::vector<std::filesystem::path> file_paths;
+    for (const auto& file : m_files){
+        if (file.kind == kind){
+            file_paths.push_back(file.path);
+        }
+    }
+    return file_paths;
+}
+
+std::size_t corpus::total_size() const noexcept
+{
+    return std::accumulate(m_files.begin(), m_files.end(), 0uz, [](auto sum, const auto& file){
+        return sum + file.size;
+    });
+}
+
+void corpus::generate()
+{
+    std::filesystem::remove_all(m_directory);
+    std::filesystem::create_directories(m_directory);
+    for (const auto& format : formats){
+        for (auto size : sizes){
+            const auto name = std::format("{}_{}.{}", format.name, size, format.extension);
+            generator g{seed(name)};
+            const auto contents = format.generate(g, size);
+            const auto path = m_directory / name;
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            if (!file){
+                throw std::filesystem::filesystem_error{
+                    "failed to write the corpus file",
+                    path,
+                    std::make_error_code(std::errc::io_error)
+                };
+            }
+            m_files.push_back({path, std::string{format.name}, format.kind, contents.size()});
+        }
+    }
+}
+
+std::string to_string(corpus::category kind)
+{
+    switch (kind){
+    case corpus::category::binary:     return "binary";
+    case corpus::category::text:       return "text";
+    case corpus::category::compressed: return "compressed";
+    }
+    return "unknown";
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,117 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace recognition::benchmarks {
+
+/**
+ * @class corpus
+ *
+ * @brief The corpus class generates the synthetic files identified by the benchmarks.
+ *
+ * @note The corpus is deterministic, the contents of each file are generated by a
+ *       std::mt19937_64 seeded with the name of the file, so the same files are
+ *       generated on every platform and every run.
+ */
+class corpus {
+public:
+
+    /**
+     * @brief The category enums are used for grouping the files of the corpus.
+     */
+    enum class category {
+        binary,     /**< Binary formats. */
+        text,       /**< Text in various encodings and languages. */
+        compressed  /**< Compressed files. */
+    };
+
+    /**
+     * @brief The file_t struct describes a file of the corpus.
+     */
+    struct file_t {
+        std::filesystem::path path;
+        std::string format;
+        category kind;
+        std::size_t size;
+    };
+
+    /**
+     * @brief The sizes of the generated files of each format, in bytes.
+     */
+    static constexpr std::array sizes{512uz, 32uz * 1024uz, 1024uz * 1024uz};
+
+    /**
+     * @brief Construct corpus, generate the files into a directory.
+     *
+     * @param[in] directory         The directory of the corpus, its previous contents are removed.
+     *
+     * @throws std::filesystem::filesystem_error if the files can not be written.
+     */
+    explicit corpus(std::filesystem::path directory);
+
+    /**
+     * @brief Get the directory of the corpus.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& directory() const noexcept;
+
+    /**
+     * @brief Get the files of the corpus.
+     */
+    [[nodiscard]]
+    const std::vector<file_t>& files() const noexcept;
+
+    /**
+     * @brief Get the file of a format and a size.
+     *
+     * @param[in] format            The name of the format, e.g. png.
+     * @param[in] size              One of the sizes.
+     *
+     * @throws std::out_of_range if there is no such file.
+     */
+    [[nodiscard]]
+    const file_t& get(std::string_view format, std::size_t size) const;
+
+    /**
+     * @brief Get the paths of the files of the corpus.
+     */
+    [[nodiscard]]
+    std::vector<std::filesystem::path> paths() const;
+
+    /**
+     * @brief Get the paths of the files of a category.
+     */
+    [[nodiscard]]
+    std::vector<std::filesystem::path> paths(category kind) const;
+
+    /**
+     * @brief Get the total size of the files of the corpus in bytes.
+     */
+    [[nodiscard]]
+    std::size_t total_size() const noexcept;
+
+private:
+    std::filesystem::path m_directory;
+    std::vector<file_t> m_files;
+
+    void generate();
+};
+
+/**
+ * @brief Convert the corpus::category to string.
+ */
+[[nodiscard]]
+std::string to_string(corpus::category kind);
+
+} /* namespace recognition::benchmarks */
+
+#endif /* CORPUS_HPP */
@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_BENCHMARKS_HPP
+#define MAGIC_BENCHMARKS_HPP
+
+#include <filesystem>
+
+#include <magic.hpp>
+
+#include "corpus.hpp"
+#include "synthetic_database.hpp"
+
+namespace recognition::benchmarks {
+
+/**
+ * @brief The environment struct holds the inputs shared by the benchmarks.
+ */
+struct environment {
+    std::filesystem::path database_file;
+    corpus files;
+    synthetic_database database;
+    std::filesystem::path trace_file;
+};
+
+/**
+ * @brief Open a magic and load the database file of the environment.
+ */
+[[nodiscard]]
+inline magic open_magic(const environment& env, magic::flags_mask_t flags_mask = magic::flags::none)
+{
+    return magic{flags_mask, env.database_file};
+}
+
+void register_magic_identify_file_benchmarks(const environment& env);
+
+void register_magic_identify_files_benchmarks(const environment& env);
+
+void register_magic_wrapper_overhead_benchmarks(const environment& env);
+
+void register_magic_startup_benchmarks(const environment& env);
+
+void register_magic_configuration_benchmarks(const environment& env);
+
+void register_magic_replay_benchmarks(const environment& env);
+
+} /* namespace recognition::benchmarks */
+
+#endif /* MAGIC_BENCHMARKS_HPP */
@@ -0,0 +1,136 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <array>
+#include <chrono>
+#include <format>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include "magic_benchmarks.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+/**
+ * @brief The flags swept by the configuration benchmarks, each one is set alone.
+ */
+constexpr std::array configuration_flags{
+    magic::flags::no_check_compress,
+    magic::flags::no_check_tar,
+    magic::flags::no_check_soft,
+    magic::flags::no_check_elf,
+    magic::flags::no_check_text,
+    magic::flags::no_check_cdf,
+    magic::flags::no_check_csv,
+    magic::flags::no_check_tokens,
+    magic::flags::no_check_encoding,
+    magic::flags::no_check_json,
+    magic::flags::no_check_simh,
+    magic::flags::no_check_builtin
+};
+
+/**
+ * @brief The parameter values swept by the configuration benchmarks, each one is set alone.
+ */
+constexpr std::array configuration_parameters{
+    std::pair{magic::parameters::bytes_max,     1024uz},
+    std::pair{magic::parameters::bytes_max,     64uz * 1024uz},
+    std::pair{magic::parameters::bytes_max,     1024uz * 1024uz},
+    std::pair{magic::parameters::encoding_max,  256uz},
+    std::pair{magic::parameters::encoding_max,  4uz * 1024uz},
+    std::pair{magic::parameters::encoding_max,  16uz * 1024uz},
+    std::pair{magic::parameters::regex_max,     1024uz},
+    std::pair{magic::parameters::elf_notes_max, 16uz}
+};
+
+/**
+ * @brief Identify the corpus files using the default configuration and a configured magic
+ *        in each iteration, alternating their order, and report the throughput of the
+ *        configured magic, its throughput delta and its accuracy relative to the default one.
+ *
+ * @note The accuracy is the percentage of the files whose types are the same as the
+ *       types identified by the default configuration.
+ */
+void measure_configuration(benchmark::State& state, const environment& env, magic& m)
+{
+    using clock = std::chrono::steady_clock;
+    auto baseline = open_magic(env);
+    const auto paths = env.files.paths();
+    const auto baseline_types = baseline.identify_files(paths);
+    magic::types_of_files_t types;
+    clock::duration baseline_time{};
+    clock::duration configured_time{};
+    bool baseline_first{true};
+    for (auto _ : state){
+        auto measure_baseline = [&]{
+            const auto start = clock::now();
+            benchmark::DoNotOptimize(baseline.identify_files(paths));
+            baseline_time += clock::now() - start;
+        };
+        auto measure_configured = [&]{
+            const auto start = clock::now();
+            types = m.identify_files(paths);
+            const auto elapsed = clock::now() - start;
+            configured_time += elapsed;
+            state.SetIterationTime(std::chrono::duration<double>{elapsed}.count());
+        };
+        if (baseline_first){
+            measure_baseline();
+            measure_configured();
+        } else {
+            measure_configured();
+            measure_baseline();
+        }
+        baseline_first = !baseline_first;
+    }
+    const auto changed = std::ranges::count_if(types, [&baseline_types](const auto& type){
+        return baseline_types.at(type.first) != type.second;
+    });
+    const auto files = static_cast<double>(paths.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(paths.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(env.files.total_size()));
+    state.counters["throughput_delta_percent"] = (
+        std::chrono::duration<double>{baseline_time} / std::chrono::duration<double>{configured_time} - 1.0
+    ) * 100.0;
+    state.counters["accuracy_percent"] = (files - static_cast<double>(changed)) / files * 100.0;
+    state.counters["changed_types"] = static_cast<double>(changed);
+}
+
+} /* namespace */
+
+void register_magic_configuration_benchmarks(const environment& env)
+{
+    benchmark::RegisterBenchmark(
+        "magic_configuration/baseline",
+        [&env](benchmark::State& state){
+            auto m = open_magic(env);
+            measure_configuration(state, env, m);
+        }
+    )->UseManualTime();
+    for (auto flag : configuration_flags){
+        benchmark::RegisterBenchmark(
+            std::format("magic_configuration/flags/{}", to_string(flag)).c_str(),
+            [&env, flag](benchmark::State& state){
+                auto m = open_magic(env, flag);
+                measure_configuration(state, env, m);
+            }
+        )->UseManualTime();
+    }
+    for (auto [parameter, value] : configuration_parameters){
+        benchmark::RegisterBenchmark(
+            std::format("magic_configuration/parameters/{}/{}", to_string(parameter), value).c_str(),
+            [&env, parameter, value](benchmark::State& state){
+                auto m = open_magic(env);
+                m.set_parameter(parameter, value);
+                measure_configuration(state, env, m);
+            }
+        )->UseManualTime();
+    }
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,83 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <array>
+#include <format>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "magic_benchmarks.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+constexpr std::array flag_variants{
+    std::pair{"none",            magic::flags::none},
+    std::pair{"mime_type",       magic::flags::mime_type},
+    std::pair{"mime",            magic::flags::mime},
+    std::pair{"continue_search", magic::flags::continue_search},
+    std::pair{"compress",        magic::flags::compress},
+    std::pair{"raw",             magic::flags::raw},
+    std::pair{"extension",       magic::flags::extension},
+    std::pair{"apple",           magic::flags::apple}
+};
+
+constexpr std::array categories{
+    corpus::category::binary,
+    corpus::category::text,
+    corpus::category::compressed
+};
+
+} /* namespace */
+
+void register_magic_identify_file_benchmarks(const environment& env)
+{
+    for (const auto& file : env.files.files()){
+        benchmark::RegisterBenchmark(
+            std::format("magic_identify_file/{}", file.path.filename().string()).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto m = open_magic(env);
+                for (auto _ : state){
+                    benchmark::DoNotOptimize(m.identify_file(file.path));
+                }
+                state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * file.size));
+                state.SetLabel(m.identify_file(file.path));
+            }
+        );
+    }
+    for (auto kind : categories){
+        benchmark::RegisterBenchmark(
+            std::format("magic_identify_file_category/{}", to_string(kind)).c_str(),
+            [&env, kind](benchmark::State& state){
+                auto m = open_magic(env);
+                const auto paths = env.files.paths(kind);
+                for (auto _ : state){
+                    for (const auto& path : paths){
+                        benchmark::DoNotOptimize(m.identify_file(path));
+                    }
+                }
+                state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * paths.size()));
+            }
+        );
+    }
+    for (const auto& [name, flag] : flag_variants){
+        benchmark::RegisterBenchmark(
+            std::format("magic_identify_file_flags/{}", name).c_str(),
+            [&env, flag](benchmark::State& state){
+                auto m = open_magic(env, flag);
+                const auto paths = env.files.paths();
+                for (auto _ : state){
+                    for (const auto& path : paths){
+                        benchmark::DoNotOptimize(m.identify_file(path));
+                    }
+                }
+                state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * paths.size()));
+                state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * env.files.total_size()));
+            }
+        );
+    }
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,57 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <benchmark/benchmark.h>
+
+#include "magic_benchmarks.hpp"
+
+namespace recognition::benchmarks {
+
+void register_magic_identify_files_benchmarks(const environment& env)
+{
+    const auto files = static_cast<std::int64_t>(env.files.files().size());
+    benchmark::RegisterBenchmark(
+        "magic_identify_files/container",
+        [&env, files](benchmark::State& state){
+            auto m = open_magic(env);
+            const auto paths = env.files.paths();
+            for (auto _ : state){
+                benchmark::DoNotOptimize(m.identify_files(paths));
+            }
+            state.SetItemsProcessed(state.iterations() * files);
+        }
+    );
+    benchmark::RegisterBenchmark(
+        "magic_identify_files/container_nothrow",
+        [&env, files](benchmark::State& state){
+            auto m = open_magic(env);
+            const auto paths = env.files.paths();
+            for (auto _ : state){
+                benchmark::DoNotOptimize(m.identify_files(paths, std::nothrow));
+            }
+            state.SetItemsProcessed(state.iterations() * files);
+        }
+    );
+    benchmark::RegisterBenchmark(
+        "magic_identify_files/directory",
+        [&env, files](benchmark::State& state){
+            auto m = open_magic(env);
+            for (auto _ : state){
+                benchmark::DoNotOptimize(m.identify_files(env.files.directory()));
+            }
+            state.SetItemsProcessed(state.iterations() * files);
+        }
+    );
+    benchmark::RegisterBenchmark(
+        "magic_identify_files/directory_nothrow",
+        [&env, files](benchmark::State& state){
+            auto m = open_magic(env);
+            for (auto _ : state){
+                benchmark::DoNotOptimize(m.identify_files(env.files.directory(), std::nothrow));
+            }
+            state.SetItemsProcessed(state.iterations() * files);
+        }
+    );
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,46 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "trace_replay.hpp"
+#include "magic_benchmarks.hpp"
+
+namespace recognition::benchmarks {
+
+void register_magic_replay_benchmarks(const environment& env)
+{
+    if (env.trace_file.empty()){
+        return;
+    }
+    auto replay = std::make_shared<trace_replay>(
+        env.trace_file, env.database_file, env.files.directory().parent_path() / "prefixes"
+    );
+    benchmark::RegisterBenchmark(
+        std::format("magic_replay/{}", env.trace_file.filename().string()).c_str(),
+        [replay](benchmark::State& state){
+            using microseconds = std::chrono::duration<double, std::micro>;
+            std::vector<std::chrono::nanoseconds> durations;
+            std::size_t calls{};
+            std::size_t mismatches{};
+            for (auto _ : state){
+                auto result = replay->run(trace_replay::pacing::fast);
+                state.SetIterationTime(std::chrono::duration<double>{result.elapsed}.count());
+                calls += result.calls;
+                mismatches += result.mismatches;
+                durations.insert(durations.end(), result.durations.begin(), result.durations.end());
+            }
+            state.SetItemsProcessed(static_cast<std::int64_t>(calls));
+            state.counters["p50_us"] = microseconds{percentile(durations, 50)}.count();
+            state.counters["p99_us"] = microseconds{percentile(durations, 99)}.count();
+            state.counters["recorded_p50_us"] = microseconds{percentile(replay->recorded_durations(), 50)}.count();
+            state.counters["recorded_p99_us"] = microseconds{percentile(replay->recorded_durations(), 99)}.count();
+            state.counters["mismatches"] = static_cast<double>(mismatches) / static_cast<double>(state.iterations());
+        }
+    )->UseManualTime()->Unit(benchmark::kMillisecond);
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,133 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <chrono>
+#include <format>
+#include <string>
+#include <vector>
+#include <utility>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "magic_benchmarks.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+constexpr std::size_t steady_state_calls = 16;
+
+/**
+ * @brief Evict the cached pages of a file, or of the files of a directory, from the page cache.
+ *
+ * @note posix_fadvise(POSIX_FADV_DONTNEED) is permitted for every readable file, unlike
+ *       /proc/sys/vm/drop_caches, and drops only the clean pages which are not mapped.
+ */
+void evict_from_page_cache(const std::filesystem::path& path)
+{
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error)){
+        for (const auto& entry : std::filesystem::recursive_directory_iterator{path, error}){
+            if (entry.is_regular_file(error)){
+                evict_from_page_cache(entry.path());
+            }
+        }
+        return;
+    }
+    const auto descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0){
+        return;
+    }
+    ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(descriptor);
+}
+
+/**
+ * @brief Evict a database file, and its compiled form which libmagic prefers, from the page cache.
+ */
+void evict_database_from_page_cache(const std::filesystem::path& database_file)
+{
+    evict_from_page_cache(database_file);
+    auto compiled_database_file = database_file;
+    compiled_database_file += ".mgc";
+    evict_from_page_cache(compiled_database_file);
+}
+
+[[nodiscard]]
+std::vector<std::pair<std::string, std::filesystem::path>> startup_databases(const environment& env)
+{
+    std::vector<std::pair<std::string, std::filesystem::path>> databases{
+        {"default", env.database_file},
+        {"synthetic_text", env.database.text_file()},
+        {"synthetic_compiled", env.database.compiled_file()}
+    };
+#ifdef MAGICXX_BUNDLED_DATABASE_DIRECTORY
+    const std::filesystem::path bundled_database_directory{MAGICXX_BUNDLED_DATABASE_DIRECTORY};
+    if (std::filesystem::is_directory(bundled_database_directory / "Magdir")){
+        databases.emplace_back("bundled_text", bundled_database_directory / "Magdir");
+    }
+    if (std::filesystem::is_regular_file(bundled_database_directory / "magic.mgc")){
+        databases.emplace_back("bundled_compiled", bundled_database_directory / "magic.mgc");
+    }
+#endif
+    return databases;
+}
+
+} /* namespace */
+
+void register_magic_startup_benchmarks(const environment& env)
+{
+    for (auto [name, database_file] : startup_databases(env)){
+        for (bool cold : {false, true}){
+            benchmark::RegisterBenchmark(
+                std::format("magic_startup/{}/{}", name, cold ? "cold" : "warm").c_str(),
+                [&env, database_file, cold](benchmark::State& state){
+                    using clock = std::chrono::steady_clock;
+                    using microseconds = std::chrono::duration<double, std::micro>;
+                    const auto& input = env.files.get("png", corpus::sizes[1]).path;
+                    microseconds open_time{};
+                    microseconds load_time{};
+                    microseconds first_identification_time{};
+                    microseconds steady_state_time{};
+                    for (auto _ : state){
+                        if (cold){
+                            evict_database_from_page_cache(database_file);
+                            evict_from_page_cache(input);
+                        }
+                        const auto start = clock::now();
+                        magic m;
+                        m.open(magic::flags::none);
+                        const auto opened = clock::now();
+                        m.load_database_file(database_file);
+                        const auto loaded = clock::now();
+                        benchmark::DoNotOptimize(m.identify_file(input));
+                        const auto identified = clock::now();
+                        for (std::size_t i{}; i < steady_state_calls; ++i){
+                            benchmark::DoNotOptimize(m.identify_file(input));
+                        }
+                        const auto steady_state = clock::now();
+                        open_time += opened - start;
+                        load_time += loaded - opened;
+                        first_identification_time += identified - loaded;
+                        steady_state_time += steady_state - identified;
+                        state.SetIterationTime(std::chrono::duration<double>{identified - start}.count());
+                    }
+                    const auto iterations = static_cast<double>(state.iterations());
+                    state.counters["open_us"] = open_time.count() / iterations;
+                    state.counters["load_us"] = load_time.count() / iterations;
+                    state.counters["first_identification_us"] = first_identification_time.count() / iterations;
+                    state.counters["steady_state_us"] = steady_state_time.count() / iterations / steady_state_calls;
+                    state.counters["time_to_first_identification_us"] =
+                        (open_time + load_time + first_identification_time).count() / iterations;
+                    state.SetLabel(database_file.string());
+                }
+            )->UseManualTime()->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+} /* namespace recognition::benchmarks */
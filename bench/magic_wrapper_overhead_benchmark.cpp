@@ -0,0 +1,244 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <array>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <magic.h>
+#include <benchmark/benchmark.h>
+
+#include "magic_benchmarks.hpp"
+#include "allocation_counter.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+/**
+ * @brief The files identified by the wrapper overhead benchmarks.
+ */
+constexpr std::array overhead_formats{"png", "ascii", "gzip"};
+constexpr auto overhead_size = corpus::sizes[1];
+
+using cookie_t = std::unique_ptr<magic_set, decltype(&magic_close)>;
+
+[[nodiscard]]
+cookie_t open_cookie(const environment& env)
+{
+    cookie_t cookie{magic_open(MAGIC_NONE), &magic_close};
+    if (!cookie || magic_load(cookie.get(), env.database_file.c_str()) != 0){
+        throw std::runtime_error{std::format("failed to load {} using libmagic", env.database_file.string())};
+    }
+    return cookie;
+}
+
+[[nodiscard]]
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+/**
+ * @brief Measure the raw libmagic call and the magic call on the same input in each iteration,
+ *        alternating their order, and report the mean time of each call, the overhead of the
+ *        magic call, and the allocations made by the magic call.
+ */
+void measure_overhead(benchmark::State& state, auto raw_call, auto magic_call, std::size_t calls = 1)
+{
+    using clock = std::chrono::steady_clock;
+    clock::duration raw_time{};
+    clock::duration magic_time{};
+    std::size_t allocations{};
+    std::size_t bytes{};
+    bool raw_first{true};
+    for (auto _ : state){
+        auto measure_magic_call = [&]{
+            const auto allocations_before = allocation_count();
+            const auto bytes_before = allocated_bytes();
+            const auto start = clock::now();
+            magic_call();
+            magic_time += clock::now() - start;
+            allocations += allocation_count() - allocations_before;
+            bytes += allocated_bytes() - bytes_before;
+        };
+        auto measure_raw_call = [&]{
+            const auto start = clock::now();
+            raw_call();
+            raw_time += clock::now() - start;
+        };
+        if (raw_first){
+            measure_raw_call();
+            measure_magic_call();
+        } else {
+            measure_magic_call();
+            measure_raw_call();
+        }
+        raw_first = !raw_first;
+    }
+    const auto count = static_cast<double>(state.iterations() * calls);
+    const auto raw_ns = std::chrono::duration<double, std::nano>{raw_time}.count() / count;
+    const auto magic_ns = std::chrono::duration<double, std::nano>{magic_time}.count() / count;
+    state.counters["raw_ns"] = raw_ns;
+    state.counters["magic_ns"] = magic_ns;
+    state.counters["overhead_ns"] = magic_ns - raw_ns;
+    state.counters["allocations"] = static_cast<double>(allocations) / count;
+    state.counters["allocated_bytes"] = static_cast<double>(bytes) / count;
+}
+
+} /* namespace */
+
+void register_magic_wrapper_overhead_benchmarks(const environment& env)
+{
+    for (auto format : overhead_formats){
+        const auto& file = env.files.get(format, overhead_size);
+        const auto name = file.path.filename().string();
+        benchmark::RegisterBenchmark(
+            std::format("magic_wrapper_overhead/identify_file/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto cookie = open_cookie(env);
+                auto m = open_magic(env);
+                measure_overhead(state,
+                    [&]{ benchmark::DoNotOptimize(magic_file(cookie.get(), file.path.c_str())); },
+                    [&]{ benchmark::DoNotOptimize(m.identify_file(file.path)); }
+                );
+            }
+        );
+        benchmark::RegisterBenchmark(
+            std::format("magic_wrapper_overhead/identify_file_nothrow/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto cookie = open_cookie(env);
+                auto m = open_magic(env);
+                measure_overhead(state,
+                    [&]{ benchmark::DoNotOptimize(magic_file(cookie.get(), file.path.c_str())); },
+                    [&]{ benchmark::DoNotOptimize(m.identify_file(file.path, std::nothrow)); }
+                );
+            }
+        );
+        benchmark::RegisterBenchmark(
+            std::format("magic_wrapper_overhead/identify_file_string_path/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto cookie = open_cookie(env);
+                auto m = open_magic(env);
+                const auto path = file.path.string();
+                measure_overhead(state,
+                    [&]{ benchmark::DoNotOptimize(magic_file(cookie.get(), path.c_str())); },
+                    [&]{ benchmark::DoNotOptimize(m.identify_file(path)); }
+                );
+            }
+        );
+        benchmark::RegisterBenchmark(
+            std::format("magic_wrapper_overhead/identify_file_error/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto cookie = open_cookie(env);
+                auto m = open_magic(env, magic::flags::error);
+                magic_setflags(cookie.get(), MAGIC_ERROR);
+                const auto missing_path = file.path.string() + ".missing";
+                measure_overhead(state,
+                    [&]{ benchmark::DoNotOptimize(magic_file(cookie.get(), missing_path.c_str())); },
+                    [&]{
+                        try {
+                            benchmark::DoNotOptimize(m.identify_file(missing_path));
+                        } catch (const magic_file_error&){
+                        }
+                    }
+                );
+            }
+        );
+        benchmark::RegisterBenchmark(
+            std::format("magic_wrapper_overhead/identify_file_error_nothrow/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto cookie = open_cookie(env);
+                auto m = open_magic(env, magic::flags::error);
+                magic_setflags(cookie.get(), MAGIC_ERROR);
+                const std::filesystem::path missing_path{file.path.string() + ".missing"};
+                measure_overhead(state,
+                    [&]{ benchmark::DoNotOptimize(magic_file(cookie.get(), missing_path.c_str())); },
+                    [&]{ benchmark::DoNotOptimize(m.identify_file(missing_path, std::nothrow)); }
+                );
+            }
+        );
+        benchmark::RegisterBenchmark(
+            std::format("magic_wrapper_overhead_statistics/identify_file/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto m = open_magic(env);
+                auto observed_magic = open_magic(env);
+                observed_magic.enable_statistics();
+                measure_overhead(state,
+                    [&]{ benchmark::DoNotOptimize(m.identify_file(file.path)); },
+                    [&]{ benchmark::DoNotOptimize(observed_magic.identify_file(file.path)); }
+                );
+                state.SetLabel("raw_ns without the statistics, magic_ns with the statistics enabled");
+            }
+        );
+        benchmark::RegisterBenchmark(
+            std::format("magic_raw/magic_buffer/{}", name).c_str(),
+            [&env, &file](benchmark::State& state){
+                auto cookie = open_cookie(env);
+                const auto contents = read_file(file.path);
+                for (auto _ : state){
+                    benchmark::DoNotOptimize(magic_buffer(cookie.get(), contents.data(), contents.size()));
+                }
+                state.SetLabel("in memory identification without the file I/O of magic_file");
+            }
+        );
+    }
+    benchmark::RegisterBenchmark(
+        "magic_wrapper_overhead/identify_files/container",
+        [&env](benchmark::State& state){
+            auto cookie = open_cookie(env);
+            auto m = open_magic(env);
+            const auto paths = env.files.paths();
+            measure_overhead(state,
+                [&]{
+                    for (const auto& path : paths){
+                        benchmark::DoNotOptimize(magic_file(cookie.get(), path.c_str()));
+                    }
+                },
+                [&]{ benchmark::DoNotOptimize(m.identify_files(paths)); },
+                paths.size()
+            );
+        }
+    );
+    benchmark::RegisterBenchmark(
+        "magic_wrapper_overhead/identify_files/container_nothrow",
+        [&env](benchmark::State& state){
+            auto cookie = open_cookie(env);
+            auto m = open_magic(env);
+            const auto paths = env.files.paths();
+            measure_overhead(state,
+                [&]{
+                    for (const auto& path : paths){
+                        benchmark::DoNotOptimize(magic_file(cookie.get(), path.c_str()));
+                    }
+                },
+                [&]{ benchmark::DoNotOptimize(m.identify_files(paths, std::nothrow)); },
+                paths.size()
+            );
+        }
+    );
+    benchmark::RegisterBenchmark(
+        "magic_wrapper_overhead/identify_files/directory",
+        [&env](benchmark::State& state){
+            auto cookie = open_cookie(env);
+            auto m = open_magic(env);
+            const auto paths = env.files.paths();
+            measure_overhead(state,
+                [&]{
+                    for (const auto& entry : std::filesystem::recursive_directory_iterator{env.files.directory()}){
+                        benchmark::DoNotOptimize(magic_file(cookie.get(), entry.path().c_str()));
+                    }
+                },
+                [&]{ benchmark::DoNotOptimize(m.identify_files(env.files.directory())); },
+                paths.size()
+            );
+        }
+    );
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,88 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <iostream>
+#include <string_view>
+
+#include <magic.hpp>
+
+#include "trace_replay.hpp"
+
+namespace {
+
+constexpr std::string_view pacing_flag{"--pacing="};
+constexpr std::string_view database_file_flag{"--database_file="};
+constexpr std::string_view prefix_directory_flag{"--prefix_directory="};
+
+using microseconds = std::chrono::duration<double, std::micro>;
+
+void print_latencies(std::string_view name, const std::vector<std::chrono::nanoseconds>& durations)
+{
+    using namespace recognition::benchmarks;
+    std::cout << std::format(
+        "{:<10} p50 {:>10.1f} us  p90 {:>10.1f} us  p99 {:>10.1f} us  max {:>10.1f} us\n",
+        name,
+        microseconds{percentile(durations, 50)}.count(),
+        microseconds{percentile(durations, 90)}.count(),
+        microseconds{percentile(durations, 99)}.count(),
+        microseconds{percentile(durations, 100)}.count()
+    );
+}
+
+} /* namespace */
+
+auto main(int argc, char** argv) -> int
+{
+    using namespace recognition;
+    using benchmarks::trace_replay;
+    auto replay_pacing = trace_replay::pacing::original;
+    std::filesystem::path database_file{magic::default_database_file};
+    auto prefix_directory = std::filesystem::temp_directory_path() / "magicxx_replay_prefixes";
+    std::filesystem::path trace_file;
+    for (int i{1}; i < argc; ++i){
+        std::string_view argument{argv[i]};
+        if (argument == "--pacing=original" || argument == "--pacing=fast"){
+            replay_pacing = argument.substr(pacing_flag.size()) == "fast" ?
+                trace_replay::pacing::fast : trace_replay::pacing::original;
+        } else if (argument.starts_with(database_file_flag)){
+            database_file = argument.substr(database_file_flag.size());
+        } else if (argument.starts_with(prefix_directory_flag)){
+            prefix_directory = argument.substr(prefix_directory_flag.size());
+        } else if (!argument.starts_with("--") && trace_file.empty()){
+            trace_file = argument;
+        } else {
+            trace_file.clear();
+            break;
+        }
+    }
+    if (trace_file.empty()){
+        std::cerr << std::format(
+            "usage: {} [options] <trace file>\n"
+            "  {}original|fast          Issue the calls at their recorded offsets, or back to back (default: original).\n"
+            "  {}<path>          The database file (default: {}).\n"
+            "  {}<directory>  The directory of the captured prefixes (default: {}).\n",
+            argv[0],
+            pacing_flag,
+            database_file_flag, magic::default_database_file,
+            prefix_directory_flag, prefix_directory.string()
+        );
+        return 1;
+    }
+    try {
+        const trace_replay replay{trace_file, database_file, prefix_directory};
+        const auto result = replay.run(replay_pacing);
+        const auto seconds = std::chrono::duration<double>{result.elapsed}.count();
+        std::cout << std::format(
+            "{} calls replayed in {:.3f} s, {:.1f} calls/s, {} mismatches\n",
+            result.calls, seconds, seconds > 0 ? static_cast<double>(result.calls) / seconds : 0.0,
+            result.mismatches
+        );
+        print_latencies("recorded", replay.recorded_durations());
+        print_latencies("replayed", result.durations);
+        return result.mismatches == 0 ? 0 : 2;
+    } catch (const std::exception& error){
+        std::cerr << std::format("{}: {}\n", argv[0], error.what());
+        return 1;
+    }
+}
@@ -0,0 +1,63 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <iostream>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "magic_benchmarks.hpp"
+
+namespace {
+
+constexpr std::string_view corpus_directory_flag{"--magicxx_corpus_directory="};
+constexpr std::string_view database_file_flag{"--magicxx_database_file="};
+constexpr std::string_view trace_file_flag{"--magicxx_trace_file="};
+
+} /* namespace */
+
+auto main(int argc, char** argv) -> int
+{
+    using namespace recognition;
+    benchmark::Initialize(&argc, argv);
+    auto corpus_directory = std::filesystem::temp_directory_path() / "magicxx_benchmark_corpus";
+    std::filesystem::path database_file{magic::default_database_file};
+    std::filesystem::path trace_file;
+    for (int i{1}; i < argc; ++i){
+        std::string_view argument{argv[i]};
+        if (argument.starts_with(corpus_directory_flag)){
+            corpus_directory = argument.substr(corpus_directory_flag.size());
+        } else if (argument.starts_with(database_file_flag)){
+            database_file = argument.substr(database_file_flag.size());
+        } else if (argument.starts_with(trace_file_flag)){
+            trace_file = argument.substr(trace_file_flag.size());
+        } else {
+            std::cerr << std::format(
+                "{}: unrecognized argument '{}', the magicxx arguments are:\n"
+                "  {}<directory>  The directory of the generated corpus and database (default: {}).\n"
+                "  {}<path>          The database file (default: {}).\n"
+                "  {}<path>             The trace file replayed by the magic_replay benchmark.\n",
+                argv[0], argument,
+                corpus_directory_flag, corpus_directory.string(),
+                database_file_flag, magic::default_database_file,
+                trace_file_flag
+            );
+            return 1;
+        }
+    }
+    benchmarks::environment env{
+        database_file,
+        benchmarks::corpus{corpus_directory / "files"},
+        benchmarks::synthetic_database{corpus_directory / "database"},
+        trace_file
+    };
+    benchmarks::register_magic_identify_file_benchmarks(env);
+    benchmarks::register_magic_identify_files_benchmarks(env);
+    benchmarks::register_magic_wrapper_overhead_benchmarks(env);
+    benchmarks::register_magic_startup_benchmarks(env);
+    benchmarks::register_magic_configuration_benchmarks(env);
+    benchmarks::register_magic_replay_benchmarks(env);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
@@ -0,0 +1,104 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <random>
+#include <fstream>
+#include <stdexcept>
+
+#include <magic.hpp>
+
+#include "synthetic_database.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+[[nodiscard]]
+std::string entry(std::size_t i, std::mt19937_64& engine)
+{
+    const auto offset = engine() % 1024;
+    switch (i % 10){
+    case 4:
+        return std::format(
+            "{}\tbelong\t0x{:08x}\tmagicxx synthetic big endian type {}\n"
+            ">{}\tleshort\t>0\t\\b, count %d\n",
+            offset, engine() & 0xffffffff, i, offset + 4
+        );
+    case 5:
+        return std::format(
+            "{}\tleshort\t0x{:04x}\tmagicxx synthetic little endian type {}\n"
+            ">{}\tbyte\t1\t\\b, first kind\n"
+            ">{}\tbyte\t2\t\\b, second kind\n"
+            ">>{}\tlelong\tx\t\\b, length %u\n",
+            offset, engine() & 0xffff, i, offset + 2, offset + 2, offset + 3
+        );
+    case 6:
+        return std::format(
+            "{}\tlequad\t0x{:016x}\tmagicxx synthetic quad type {}\n",
+            offset, engine(), i
+        );
+    case 7:
+        return std::format(
+            "0\tsearch/256\tMXS-SEARCH-{:05}\tmagicxx synthetic search type {}\n",
+            i, i
+        );
+    case 8:
+        return std::format(
+            "0\tregex\t^MXS-REGEX-{:05}[0-9]+\tmagicxx synthetic regex type {}\n",
+            i, i
+        );
+    case 9:
+        return std::format(
+            "0\tstring\tMXS-MIME-{:05}\tmagicxx synthetic mime type {}\n"
+            "!:mime\tapplication/x-magicxx-synthetic-{}\n",
+            i, i, i
+        );
+    default:
+        return std::format(
+            "0\tstring\tMXS{:05}\tmagicxx synthetic string type {}\n"
+            ">8\tbyte\tx\t\\b, version %d\n",
+            i, i
+        );
+    }
+}
+
+} /* namespace */
+
+synthetic_database::synthetic_database(std::filesystem::path directory, std::size_t entries)
+    : m_text_file{directory / "magicxx_synthetic"},
+      m_compiled_file{directory / "compiled" / "magicxx_synthetic.mgc"}
+{
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(m_compiled_file.parent_path());
+    {
+        std::ofstream database{m_text_file, std::ios::trunc};
+        std::mt19937_64 engine{entries};
+        for (std::size_t i{}; i < entries; ++i){
+            database << entry(i, engine);
+        }
+        if (!database){
+            throw std::runtime_error{std::format("failed to write {}", m_text_file.string())};
+        }
+    }
+    magic m;
+    m.open(magic::flags::none);
+    const auto compiled_file = std::filesystem::current_path() / m_compiled_file.filename();
+    if (!m.compile(m_text_file)){
+        throw std::runtime_error{std::format("failed to compile {}", m_text_file.string())};
+    }
+    std::filesystem::copy_file(compiled_file, m_compiled_file, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::remove(compiled_file);
+}
+
+const std::filesystem::path& synthetic_database::text_file() const noexcept
+{
+    return m_text_file;
+}
+
+const std::filesystem::path& synthetic_database::compiled_file() const noexcept
+{
+    return m_compiled_file;
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,60 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef SYNTHETIC_DATABASE_HPP
+#define SYNTHETIC_DATABASE_HPP
+
+#include <filesystem>
+
+namespace recognition::benchmarks {
+
+/**
+ * @class synthetic_database
+ *
+ * @brief The synthetic_database class generates a large custom magic database,
+ *        and compiles it using the Magic Number Recognition Library.
+ *
+ * @note The entries are deterministic and mix the string, numeric, search and regex
+ *       tests with continuation lines, none of them matches the corpus files.
+ */
+class synthetic_database {
+public:
+
+    /**
+     * @brief The default number of the entries.
+     */
+    static constexpr std::size_t default_entries = 20000;
+
+    /**
+     * @brief Construct synthetic_database, generate and compile the database into a directory.
+     *
+     * @param[in] directory         The directory of the database, its previous contents are removed.
+     * @param[in] entries           The number of the entries.
+     *
+     * @throws std::runtime_error if the database can not be written or compiled.
+     */
+    explicit synthetic_database(std::filesystem::path directory, std::size_t entries = default_entries);
+
+    /**
+     * @brief Get the path of the text database file.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& text_file() const noexcept;
+
+    /**
+     * @brief Get the path of the compiled database file.
+     *
+     * @note The compiled database file is not placed next to the text database file,
+     *       otherwise the Magic Number Recognition Library loads it instead of the text one.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& compiled_file() const noexcept;
+
+private:
+    std::filesystem::path m_text_file;
+    std::filesystem::path m_compiled_file;
+};
+
+} /* namespace recognition::benchmarks */
+
+#endif /* SYNTHETIC_DATABASE_HPP */
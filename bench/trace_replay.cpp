@@ -0,0 +1,119 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cmath>
+#include <format>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+
+#include <magic.hpp>
+
+#include "trace_replay.hpp"
+
+namespace recognition::benchmarks {
+
+namespace {
+
+[[nodiscard]]
+bool is_identify_call(const trace::record& trace_record) noexcept
+{
+    return trace_record.kind == trace::call::identify_file ||
+           trace_record.kind == trace::call::identify_file_nothrow;
+}
+
+} /* namespace */
+
+trace_replay::trace_replay(
+    const std::filesystem::path& trace_file,
+    std::filesystem::path database_file,
+    const std::filesystem::path& prefix_directory)
+    : m_records{trace::read(trace_file)},
+      m_database_file{std::move(database_file)}
+{
+    for (auto& trace_record : m_records){
+        if (!is_identify_call(trace_record) || trace_record.prefix.empty() ||
+            std::filesystem::exists(trace_record.path)){
+            continue;
+        }
+        std::filesystem::create_directories(prefix_directory);
+        auto prefix_file = prefix_directory / std::format("{:016x}", trace_record.input_hash);
+        if (!std::filesystem::exists(prefix_file)){
+            std::ofstream file{prefix_file, std::ios::binary | std::ios::trunc};
+            file.write(trace_record.prefix.data(), static_cast<std::streamsize>(trace_record.prefix.size()));
+        }
+        trace_record.path = std::move(prefix_file);
+    }
+}
+
+const std::vector<trace::record>& trace_replay::records() const noexcept
+{
+    return m_records;
+}
+
+std::vector<std::chrono::nanoseconds> trace_replay::recorded_durations() const
+{
+    std::vector<std::chrono::nanoseconds> durations;
+    for (const auto& trace_record : m_records){
+        if (is_identify_call(trace_record)){
+            durations.push_back(trace_record.duration);
+        }
+    }
+    return durations;
+}
+
+trace_replay::result_t trace_replay::run(pacing replay_pacing) const
+{
+    using clock = std::chrono::steady_clock;
+    magic m{magic::flags::none, m_database_file};
+    std::uint64_t flags_mask{};
+    result_t result{};
+    const auto start = clock::now();
+    for (const auto& trace_record : m_records){
+        if (replay_pacing == pacing::original){
+            std::this_thread::sleep_until(start + trace_record.offset);
+        }
+        if (trace_record.flags_mask != flags_mask){
+            m.set_flags(magic::flags_mask_t{trace_record.flags_mask});
+            flags_mask = trace_record.flags_mask;
+        }
+        switch (trace_record.kind){
+        case trace::call::identify_file:
+        case trace::call::identify_file_nothrow: {
+            const auto call_start = clock::now();
+            const auto expected_file_type = m.identify_file(trace_record.path, std::nothrow);
+            result.durations.push_back(clock::now() - call_start);
+            result.mismatches += expected_file_type.has_value() != trace_record.succeeded;
+            ++result.calls;
+            break;
+        }
+        case trace::call::load_database_file:
+        case trace::call::load_database_buffer: {
+            const auto& database_file = std::filesystem::exists(trace_record.path) ?
+                trace_record.path : m_database_file;
+            try {
+                m.load_database_file(database_file);
+            } catch (const magic_exception&){
+            }
+            break;
+        }
+        }
+    }
+    result.elapsed = clock::now() - start;
+    return result;
+}
+
+std::chrono::nanoseconds percentile(std::vector<std::chrono::nanoseconds> durations, double percentile)
+{
+    if (durations.empty()){
+        return {};
+    }
+    const auto index = static_cast<std::size_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(durations.size()))
+    );
+    const auto nth = durations.begin() + static_cast<std::ptrdiff_t>(std::clamp(index, 1uz, durations.size()) - 1);
+    std::ranges::nth_element(durations, nth);
+    return *nth;
+}
+
+} /* namespace recognition::benchmarks */
@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef TRACE_REPLAY_HPP
+#define TRACE_REPLAY_HPP
+
+#include <chrono>
+#include <vector>
+#include <filesystem>
+
+#include <magic_trace.hpp>
+
+namespace recognition::benchmarks {
+
+/**
+ * @class trace_replay
+ *
+ * @brief The trace_replay class re-issues the calls recorded by magic::start_recording().
+ *
+ * @note The identified files which no longer exist are replaced by their captured
+ *       prefixes, and the recorded database buffers by the database file, so a trace
+ *       recorded elsewhere is replayed against any build of libmagicxx.
+ */
+class trace_replay {
+public:
+
+    /**
+     * @brief The pacing enums are used for selecting the pacing of the replay.
+     */
+    enum class pacing {
+        original, /**< Issue each call at its recorded offset. */
+        fast      /**< Issue each call as soon as the previous one returns. */
+    };
+
+    /**
+     * @brief The result_t struct describes a replay of a trace.
+     */
+    struct result_t {
+        std::size_t calls;                                  /**< The number of the identify calls. */
+        std::size_t mismatches;                             /**< The number of the calls whose success differs from the recorded one. */
+        std::chrono::nanoseconds elapsed;                   /**< The duration of the replay. */
+        std::vector<std::chrono::nanoseconds> durations;    /**< The durations of the identify calls. */
+    };
+
+    /**
+     * @brief Construct trace_replay, read a trace file.
+     *
+     * @param[in] trace_file        The path of the trace file.
+     * @param[in] database_file     The database file loaded before the replay, and instead of the recorded
+     *                              database buffers and the recorded database files which no longer exist.
+     * @param[in] prefix_directory  The directory where the captured prefixes are written.
+     *
+     * @throws magic_trace_error if the trace file can not be read.
+     */
+    trace_replay(
+        const std::filesystem::path& trace_file,
+        std::filesystem::path database_file,
+        const std::filesystem::path& prefix_directory
+    );
+
+    /**
+     * @brief Get the recorded calls.
+     */
+    [[nodiscard]]
+    const std::vector<trace::record>& records() const noexcept;
+
+    /**
+     * @brief Get the recorded durations of the identify calls.
+     */
+    [[nodiscard]]
+    std::vector<std::chrono::nanoseconds> recorded_durations() const;
+
+    /**
+     * @brief Replay the recorded calls using a new magic.
+     */
+    [[nodiscard]]
+    result_t run(pacing replay_pacing) const;
+
+private:
+    std::vector<trace::record> m_records;
+    std::filesystem::path m_database_file;
+};
+
+/**
+ * @brief Get a percentile of durations, percentile is in [0, 100].
+ */
+[[nodiscard]]
+std::chrono::nanoseconds percentile(std::vector<std::chrono::nanoseconds> durations, double percentile);
+
+} /* namespace recognition::benchmarks */
+
+#endif /* TRACE_REPLAY_HPP */
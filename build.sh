@@ -7,25 +7,34 @@ BUILD_DIR="release_build"
 BUILD_TYPE="Release"
 COMPILER="g++"
 RUN_TESTS="OFF"
+BUILD_BENCHMARKS="OFF"
+STATISTICS="ON"
+HEAP_ACCOUNTING="OFF"
 
 usage(){
-    echo "Usage: $0 [-d build_dir] [-b build_type] [-c compiler] [-t] [-h]"
+    echo "Usage: $0 [-d build_dir] [-b build_type] [-c compiler] [-t] [-e] [-n] [-a] [-h]"
     echo "  -d build_dir   Specify the build directory (default: ${BUILD_DIR})."
     echo "  -b build_type  Specify the CMake build type (default: ${BUILD_TYPE})."
     echo "  -c compiler    Specify the compiler (g++ or clang++, default: ${COMPILER})."
     echo "  -t             Build and run tests (default: ${RUN_TESTS})."
+    echo "  -e             Build the benchmarks (default: ${BUILD_BENCHMARKS})."
+    echo "  -n             Build without the statistics of the identifications (default: statistics=${STATISTICS})."
+    echo "  -a             Link libmagic statically, counting its heap exactly (default: heap_accounting=${HEAP_ACCOUNTING})."
     echo "  -h             Display this message."
     exit 1
 }
 
 DISPLAY_USAGE=true
 
-while getopts 'd:b:c:ht' OPTION; do
+while getopts 'd:b:c:htena' OPTION; do
     case ${OPTION} in
         d) BUILD_DIR=$OPTARG  DISPLAY_USAGE=false;;
         b) BUILD_TYPE=$OPTARG DISPLAY_USAGE=false;;
         c) COMPILER=$OPTARG   DISPLAY_USAGE=false;;
         t) RUN_TESTS="ON"     DISPLAY_USAGE=false;;
+        e) BUILD_BENCHMARKS="ON" DISPLAY_USAGE=false;;
+        n) STATISTICS="OFF"   DISPLAY_USAGE=false;;
+        a) HEAP_ACCOUNTING="ON" DISPLAY_USAGE=false;;
         *) usage;;
     esac
 done
@@ -34,9 +43,9 @@ if [ "$DISPLAY_USAGE" = true ] && [ $# -gt 0 ]; then
     usage
 fi
 
-echo "Selected options: build_dir=${BUILD_DIR}, build_type=${BUILD_TYPE}, compiler=${COMPILER}, build and run tests=${RUN_TESTS}"
+echo "Selected options: build_dir=${BUILD_DIR}, build_type=${BUILD_TYPE}, compiler=${COMPILER}, build and run tests=${RUN_TESTS}, build benchmarks=${BUILD_BENCHMARKS}, statistics=${STATISTICS}, heap_accounting=${HEAP_ACCOUNTING}"
 
-cmake -DCMAKE_BUILD_TYPE:STRING=${BUILD_TYPE} -DBUILD_MAGICXX_TESTS=${RUN_TESTS} -DCMAKE_CXX_COMPILER:FILEPATH=${COMPILER} -G Ninja -S . -B ${BUILD_DIR} || {
+cmake -DCMAKE_BUILD_TYPE:STRING=${BUILD_TYPE} -DBUILD_MAGICXX_TESTS=${RUN_TESTS} -DBUILD_MAGICXX_BENCHMARKS=${BUILD_BENCHMARKS} -DCMAKE_CXX_COMPILER:FILEPATH=${COMPILER} -DBUILD_MAGICXX_WITH_STATISTICS=${STATISTICS} -DBUILD_MAGICXX_WITH_LIBMAGIC_HEAP_ACCOUNTING=${HEAP_ACCOUNTING} -G Ninja -S . -B ${BUILD_DIR} || {
     exit 2
 }
 
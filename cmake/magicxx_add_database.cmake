@@ -0,0 +1,136 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com>
+# SPDX-License-Identifier: LGPL-3.0-only
+
+#
+# magicxx_add_database(<target>
+#     SOURCES <file or directory>...
+#     [OUTPUT_NAME <name>]
+#     [INSTALL_DESTINATION <directory> | NO_INSTALL]
+#     [EMBED]
+# )
+#
+# Compiles the magic database sources into <name>.mgc at build time using the file command
+# of the bundled Magic Number Recognition Library, and installs it into the install destination.
+#
+#   SOURCES              The magic database files, and the directories whose files are compiled.
+#                        The names of the files must be unique.
+#   OUTPUT_NAME          The name of the compiled database file, default is <target>.
+#   INSTALL_DESTINATION  The install destination, default is ${CMAKE_INSTALL_DATADIR}/magicxx.
+#   NO_INSTALL           Do not install the compiled database file.
+#   EMBED                Add the <target>_embedded object library, whose generated <name>.hpp
+#                        header declares the function, named by the C identifier of <name>,
+#                        returning the embedded compiled database:
+#
+#                            namespace recognition::databases {
+#                                std::span<const char> <name>() noexcept;
+#                            }
+#
+#                        which is loaded by magic::load_database_buffer().
+#
+# The MAGICXX_DATABASE_FILE property of <target> is the path of the compiled database file.
+#
+
+include_guard(GLOBAL)
+
+include(GNUInstallDirs)
+
+set(magicxx_EMBED_DATABASE_SCRIPT
+    ${CMAKE_CURRENT_LIST_DIR}/magicxx_embed_database.cmake
+)
+
+function(magicxx_add_database target)
+    cmake_parse_arguments(PARSE_ARGV 1 database "EMBED;NO_INSTALL" "OUTPUT_NAME;INSTALL_DESTINATION" "SOURCES")
+    if (NOT database_SOURCES)
+        message(FATAL_ERROR "magicxx_add_database(${target}) requires SOURCES.")
+    endif()
+    if (NOT database_OUTPUT_NAME)
+        set(database_OUTPUT_NAME ${target})
+    endif()
+    if (NOT database_INSTALL_DESTINATION)
+        set(database_INSTALL_DESTINATION ${CMAKE_INSTALL_DATADIR}/magicxx)
+    endif()
+
+    set(working_directory ${CMAKE_CURRENT_BINARY_DIR}/${target})
+    set(source_directory ${working_directory}/${database_OUTPUT_NAME})
+    set(database_file ${working_directory}/${database_OUTPUT_NAME}.mgc)
+
+    file(MAKE_DIRECTORY ${working_directory})
+
+    set(copy_commands)
+    set(source_files)
+    foreach(source IN LISTS database_SOURCES)
+        cmake_path(ABSOLUTE_PATH source BASE_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR} NORMALIZE)
+        if (IS_DIRECTORY ${source})
+            file(GLOB directory_files LIST_DIRECTORIES false CONFIGURE_DEPENDS ${source}/*)
+        else()
+            set(directory_files ${source})
+        endif()
+        foreach(source_file IN LISTS directory_files)
+            list(APPEND copy_commands COMMAND ${CMAKE_COMMAND} -E copy ${source_file} ${source_directory})
+            list(APPEND source_files ${source_file})
+        endforeach()
+    endforeach()
+
+    add_custom_command(
+        OUTPUT ${database_file}
+        COMMAND ${CMAKE_COMMAND} -E rm -rf ${source_directory}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${source_directory}
+        ${copy_commands}
+        COMMAND ${magicxx_FILE_COMMAND} -C -m ${database_OUTPUT_NAME}
+        WORKING_DIRECTORY ${working_directory}
+        DEPENDS ${source_files}
+        COMMENT "Compiling the magic database ${database_OUTPUT_NAME}.mgc"
+        VERBATIM
+    )
+
+    add_custom_target(${target} ALL
+        DEPENDS ${database_file}
+    )
+
+    set_target_properties(${target} PROPERTIES
+        MAGICXX_DATABASE_FILE ${database_file}
+    )
+
+    if (NOT database_NO_INSTALL)
+        install(FILES ${database_file}
+            DESTINATION ${database_INSTALL_DESTINATION}
+        )
+    endif()
+
+    if (NOT database_EMBED)
+        return()
+    endif()
+
+    string(MAKE_C_IDENTIFIER ${database_OUTPUT_NAME} database_identifier)
+    set(embedded_include_directory ${working_directory}/include)
+    set(embedded_header ${embedded_include_directory}/${database_OUTPUT_NAME}.hpp)
+    set(embedded_source ${working_directory}/${database_OUTPUT_NAME}.cpp)
+
+    add_custom_command(
+        OUTPUT ${embedded_header} ${embedded_source}
+        COMMAND ${CMAKE_COMMAND}
+            -D database_file=${database_file}
+            -D database_identifier=${database_identifier}
+            -D embedded_header=${embedded_header}
+            -D embedded_source=${embedded_source}
+            -P ${magicxx_EMBED_DATABASE_SCRIPT}
+        DEPENDS ${database_file} ${magicxx_EMBED_DATABASE_SCRIPT}
+        COMMENT "Embedding the magic database ${database_OUTPUT_NAME}.mgc"
+        VERBATIM
+    )
+
+    add_library(${target}_embedded OBJECT)
+
+    set_target_properties(${target}_embedded PROPERTIES
+        CXX_STANDARD 23
+        CXX_EXTENSIONS OFF
+        CXX_STANDARD_REQUIRED ON
+        POSITION_INDEPENDENT_CODE ON
+        SOURCES ${embedded_source}
+        COMPILE_OPTIONS "$<$<CXX_COMPILER_ID:Clang>:-stdlib=libc++>"
+    )
+
+    target_include_directories(${target}_embedded
+        PUBLIC ${embedded_include_directory}
+    )
+endfunction()
@@ -0,0 +1,74 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com>
+# SPDX-License-Identifier: LGPL-3.0-only
+
+#
+# Generates the header and the source file embedding a compiled magic database file,
+# run by magicxx_add_database() in script mode with the following variables:
+#
+#   database_file        The path of the compiled database file.
+#   database_identifier  The name of the function returning the embedded database.
+#   embedded_header      The path of the generated header file.
+#   embedded_source      The path of the generated source file.
+#
+
+cmake_minimum_required(VERSION 3.21.0)
+
+foreach(variable IN ITEMS database_file database_identifier embedded_header embedded_source)
+    if (NOT DEFINED ${variable})
+        message(FATAL_ERROR "magicxx_embed_database.cmake requires ${variable}.")
+    endif()
+endforeach()
+
+file(READ ${database_file} database_bytes HEX)
+string(REPEAT "[0-9a-f]" 32 database_line)
+string(REGEX REPLACE "(${database_line})" "\\1\n    " database_bytes "${database_bytes}")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," database_bytes "${database_bytes}")
+string(TOUPPER ${database_identifier} header_guard)
+cmake_path(GET database_file FILENAME database_file_name)
+cmake_path(GET embedded_header FILENAME embedded_header_name)
+
+file(WRITE ${embedded_header}
+"/* Generated by magicxx_add_database() from ${database_file_name}, do not edit. */
+
+#ifndef ${header_guard}_HPP
+#define ${header_guard}_HPP
+
+#include <span>
+
+namespace recognition::databases {
+
+/**
+ * @brief Get the embedded compiled magic database ${database_file_name}.
+ *
+ * @returns The contents of ${database_file_name}, which is loaded by magic::load_database_buffer().
+ */
+[[nodiscard]]
+std::span<const char> ${database_identifier}() noexcept;
+
+} /* namespace recognition::databases */
+
+#endif /* ${header_guard}_HPP */
+")
+
+file(WRITE ${embedded_source}
+"/* Generated by magicxx_add_database() from ${database_file_name}, do not edit. */
+
+#include \"${embedded_header_name}\"
+
+namespace recognition::databases {
+
+namespace {
+
+alignas(8) constexpr unsigned char database[]{
+    ${database_bytes}
+};
+
+} /* namespace */
+
+std::span<const char> ${database_identifier}() noexcept
+{
+    return {reinterpret_cast<const char*>(database), sizeof(database)};
+}
+
+} /* namespace recognition::databases */
+")
@@ -0,0 +1,87 @@
+#!/bin/bash
+#
+# SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com>
+# SPDX-License-Identifier: LGPL-3.0-only
+
+THRESHOLD="5"
+METRIC="real_time"
+
+usage(){
+    echo "Usage: $0 [-t threshold] [-m metric] baseline.json contender.json"
+    echo "  -t threshold   Specify the regression threshold in percent (default: ${THRESHOLD})."
+    echo "  -m metric      Specify the compared metric (real_time or cpu_time, default: ${METRIC})."
+    echo "  -h             Display this message."
+    echo "The JSON files are written by magicxx_benchmarks --benchmark_out=<file> --benchmark_out_format=json,"
+    echo "the medians are compared if the benchmarks are repeated."
+    exit 1
+}
+
+while getopts 't:m:h' OPTION; do
+    case ${OPTION} in
+        t) THRESHOLD=$OPTARG;;
+        m) METRIC=$OPTARG;;
+        *) usage;;
+    esac
+done
+
+shift $((OPTIND - 1))
+
+if [ $# -ne 2 ]; then
+    usage
+fi
+
+which jq &> /dev/null || {
+    echo "Error: jq does not exist on this system."
+    exit 2
+}
+
+extract(){
+    jq -r --arg metric "${METRIC}" '
+        .benchmarks
+        | if any(.[]; .aggregate_name == "median")
+          then map(select(.aggregate_name == "median"))
+          else map(select(.run_type != "aggregate"))
+          end
+        | .[]
+        | [
+            (.run_name // .name),
+            (.[$metric] * ({"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}[.time_unit // "ns"]) | floor)
+          ]
+        | @tsv
+    ' "$1" | LC_ALL=C sort -t $'\t' -k 1,1 || {
+        echo "Error: Failed to read $1." >&2
+        exit 2
+    }
+}
+
+BASELINE=$(extract "$1") || exit 2
+CONTENDER=$(extract "$2") || exit 2
+
+LC_ALL=C join -t $'\t' -a 1 -a 2 -e "-" -o 0,1.2,2.2 <(echo "${BASELINE}") <(echo "${CONTENDER}") |
+awk -F '\t' -v threshold="${THRESHOLD}" '
+    BEGIN {
+        printf "%-60s %16s %16s %10s\n", "Benchmark", "Baseline (ns)", "Contender (ns)", "Change"
+    }
+    $2 == "-" || $3 == "-" {
+        printf "%-60s %16s %16s %10s\n", $1, $2, $3, "missing"
+        next
+    }
+    {
+        change = ($2 > 0) ? ($3 - $2) / $2 * 100 : 0
+        status = ""
+        if (change > threshold){
+            status = " REGRESSION"
+            ++regressions
+        } else if (change < -threshold){
+            status = " improvement"
+        }
+        printf "%-60s %16.0f %16.0f %+9.2f%%%s\n", $1, $2, $3, change, status
+    }
+    END {
+        if (regressions){
+            printf "%d benchmark(s) regressed more than %s%%.\n", regressions, threshold
+            exit 3
+        }
+        printf "No benchmark regressed more than %s%%.\n", threshold
+    }
+'
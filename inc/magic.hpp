@@ -5,13 +5,22 @@
 #define MAGIC_HPP
 
 #include <map>
+#include <span>
 #include <bitset>
+#include <chrono>
+#include <format>
+#include <iosfwd>
 #include <vector>
 #include <memory>
 #include <expected>
+#include <string_view>
+#include <memory_resource>
 
+#include <magic_error.hpp>
 #include <file_concepts.hpp>
 #include <magic_exception.hpp>
+#include <magic_statistics.hpp>
+#include <magic_span_tracer.hpp>
 
 namespace recognition {
 
@@ -37,14 +46,14 @@ public:
     using file_type_t = std::string;
 
     /**
-     * @brief The error_message_t typedef.
+     * @brief The error_message_t typedef, the type of magic_error::message().
      */
     using error_message_t = std::string;
 
     /**
      * @brief The expected_file_type_t typedef.
      */
-    using expected_file_type_t = std::expected<file_type_t, error_message_t>;
+    using expected_file_type_t = std::expected<file_type_t, magic_error>;
 
     /**
      * @brief The types_of_files_t typedef.
@@ -56,6 +65,60 @@ public:
      */
     using expected_types_of_files_t = std::map<std::filesystem::path, expected_file_type_t>;
 
+    /**
+     * @brief The file_error struct holds the index of a file whose identification failed,
+     *        in the container passed to identify_files(), and the error.
+     */
+    struct file_error {
+        std::size_t index;
+        magic_error error;
+
+        friend bool operator==(const file_error&, const file_error&) noexcept = default;
+    };
+
+    /**
+     * @brief The file_errors_t typedef.
+     */
+    using file_errors_t = std::vector<file_error>;
+
+    /**
+     * @brief The partial_types_of_files struct holds the types of the files identified by
+     *        identify_files() with continue_on_error, and the errors of the others.
+     */
+    struct partial_types_of_files {
+        types_of_files_t types_of_files;
+        file_errors_t errors;
+    };
+
+    /**
+     * @brief The native_path_less struct orders the native paths element by element, like the
+     *        std::filesystem::path keys of types_of_files_t, see results::compare_paths().
+     */
+    struct native_path_less {
+        using is_transparent = void;
+
+        [[nodiscard]]
+        bool operator()(std::string_view first, std::string_view second) const noexcept;
+    };
+
+    /**
+     * @brief The pmr_types_of_files_t typedef, the types_of_files_t allocated from a memory resource,
+     *        whose keys are the native paths of the files, in the same order as types_of_files_t.
+     */
+    using pmr_types_of_files_t = std::pmr::map<std::pmr::string, std::pmr::string, native_path_less>;
+
+    /**
+     * @brief The pmr_expected_file_type_t typedef.
+     */
+    using pmr_expected_file_type_t = std::expected<std::pmr::string, magic_error>;
+
+    /**
+     * @brief The pmr_expected_types_of_files_t typedef, the expected_types_of_files_t allocated
+     *        from a memory resource, whose keys are the native paths of the files, in the same
+     *        order as expected_types_of_files_t.
+     */
+    using pmr_expected_types_of_files_t = std::pmr::map<std::pmr::string, pmr_expected_file_type_t, native_path_less>;
+
     /**
      * @brief The flags enums are used for configuring the flags of a magic.
      *
@@ -126,6 +189,19 @@ public:
      */
     static constexpr auto default_database_file = "/usr/share/misc/magic";
 
+    /**
+     * @brief The continue_on_error_t struct is the tag type of the identify_files() overload
+     *        that continues after the files whose identification fails.
+     */
+    struct continue_on_error_t {
+        explicit continue_on_error_t() = default;
+    };
+
+    /**
+     * @brief The tag of the identify_files() overload that continues on error.
+     */
+    static constexpr continue_on_error_t continue_on_error{};
+
     /**
      * @brief Construct magic without opening it.
      */
@@ -226,6 +302,69 @@ public:
      */
     bool compile(const std::filesystem::path& database_file = default_database_file) const noexcept;
 
+    /**
+     * @brief Enable or disable the first bytes dispatch index.
+     *
+     * @param[in] enable            True to enable the dispatch index, false to disable it, default is true.
+     *
+     * @note When the dispatch index is enabled, the top level entries of the loaded compiled
+     *       database file are grouped by the constant bytes they test at fixed offsets, and each
+     *       file is identified using only the entries that its first bytes can match.
+     *       The results are the same as identifying the file using the whole database.
+     *       The file is opened once, its first bytes are read for selecting the entries and
+     *       libmagic reads it again through the same descriptor.
+     *
+     * @note The whole database is used if the loaded database file is not compiled,
+     *       or the compress flag is set.
+     */
+    void enable_dispatch_index(bool enable = true) noexcept;
+
+    /**
+     * @brief Enable or disable the timing of the stages of the identifications.
+     *
+     * @param[in] enable            True to enable the stage timing, false to disable it, default is true.
+     *
+     * @note When the stage timing is enabled, the durations of the traversal, stat, open,
+     *       classify and conversion stages of each identification are measured, see
+     *       identification_stage. The durations of the last identification are returned by
+     *       get_stage_durations(), and their totals are added to the statistics. The file is
+     *       read by libmagic, so the classify stage includes the I/O of the file.
+     */
+    void enable_stage_timing(bool enable = true) noexcept;
+
+    /**
+     * @brief Enable or disable the statistics of the identifications.
+     *
+     * @param[in] enable            True to enable the statistics, false to disable them, default is true.
+     *
+     * @note The statistics are disabled by default, so an identification does not read the clock
+     *       or touch the counters unless they, the type statistics or the tracing are enabled.
+     *       The identified bytes are counted only while the stage timing is enabled, from the
+     *       size found by its stat stage, see get_statistics().
+     */
+    void enable_statistics(bool enable = true) noexcept;
+
+    /**
+     * @brief Enable or disable the statistics of the identifications by the type of the files.
+     *
+     * @param[in] enable            True to enable the type statistics, false to disable them, default is true.
+     *
+     * @note When the type statistics are enabled, the calls, the identified bytes and the latencies
+     *       of the succeeded identifications are added to magic_statistics::type_costs, keyed by the
+     *       type of the file up to its first comma or semicolon, such as "PDF document" or "text/plain".
+     *       The types after the first 1024 are counted as "other". The type costs are converted to
+     *       a report by to_string(const type_costs_t&).
+     */
+    void enable_type_statistics(bool enable = true) noexcept;
+
+    /**
+     * @brief Get the directory of the compile cache.
+     *
+     * @returns The directory of the compile cache, an empty path if the compile cache is not used.
+     */
+    [[nodiscard]]
+    std::filesystem::path get_compile_cache_directory() const;
+
     /**
      * @brief Get the flags of magic.
      *
@@ -236,6 +375,18 @@ public:
     [[nodiscard]]
     flags_container_t get_flags() const;
 
+    /**
+     * @brief Get the memory held by magic.
+     *
+     * @returns The memory held by libmagic for the cookie, its loaded database and the cached
+     *          dispatch index sub databases, and by the database buffer and the dispatch index.
+     *
+     * @note The heap allocated by libmagic is counted when the cookies are opened and their
+     *       databases are loaded, exactly or as an estimate, see magic_memory_usage.
+     */
+    [[nodiscard]]
+    magic_memory_usage get_memory_usage() const noexcept;
+
     /**
      * @brief Get the value of a parameter of magic.
      *
@@ -258,6 +409,42 @@ public:
     [[nodiscard]]
     parameter_value_map_t get_parameters() const;
 
+    /**
+     * @brief Get the receiver of the spans of magic.
+     *
+     * @returns The span tracer, nullptr if the spans are not traced.
+     */
+    [[nodiscard]]
+    std::shared_ptr<trace::span_tracer> get_span_tracer() const noexcept;
+
+    /**
+     * @brief Get the durations of the stages of the last identification.
+     *
+     * @returns The durations indexed by the identification_stage enums, zeros if the stage
+     *          timing is not enabled, see enable_stage_timing().
+     *
+     * @note The traversal duration of identify_files() is the time spent advancing the
+     *       directory iterator or the container before the file is identified.
+     */
+    [[nodiscard]]
+    stage_durations_t get_stage_durations() const noexcept;
+
+    /**
+     * @brief Get a snapshot of the statistics of the identifications.
+     *
+     * @returns The numbers of the calls, the errors, the identified bytes and the dispatch index
+     *          cache lookups, and the latency histogram of the calls, since the construction of
+     *          magic or the last reset_statistics() call.
+     *
+     * @note The statistics are recorded only while they are enabled by enable_statistics(),
+     *       and never if libmagicxx is built with BUILD_MAGICXX_WITH_STATISTICS=OFF.
+     *
+     * @note The identified bytes are the sizes of the regular files identified while the stage
+     *       timing is enabled, the other identifications do not examine the files again to count them.
+     */
+    [[nodiscard]]
+    magic_statistics get_statistics() const noexcept;
+
     /**
      * @brief Get the version of the Magic Number Recognition Library.
      *
@@ -333,6 +520,53 @@ public:
         );
     }
 
+    /**
+     * @brief Identify the types of all files in a directory, allocating the result from a memory resource.
+     *
+     * @param[in] directory         The path of the directory.
+     * @param[in] memory_resource   The memory resource of the map, its keys and its values.
+     * @param[in] option            The directory iteration option, default is follow_directory_symlink.
+     *
+     * @returns The types of each file as a map.
+     *
+     * @throws magic_is_closed      if magic is closed.
+     * @throws empty_path           if the path of the file is empty.
+     * @throws magic_file_error     if identifying the type of the file fails.
+     */
+    [[nodiscard]]
+    pmr_types_of_files_t identify_files(
+        const std::filesystem::path& directory,
+        std::pmr::memory_resource* memory_resource,
+        std::filesystem::directory_options option = std::filesystem::directory_options::follow_directory_symlink
+    ) const
+    {
+        return identify_files_impl(
+            std::filesystem::recursive_directory_iterator{directory, option}, memory_resource
+        );
+    }
+
+    /**
+     * @brief Identify the types of all files in a directory, allocating the result from a memory resource,
+     *        noexcept version.
+     *
+     * @param[in] directory         The path of the directory.
+     * @param[in] memory_resource   The memory resource of the map, its keys and its values.
+     * @param[in] option            The directory iteration option, default is follow_directory_symlink.
+     *
+     * @returns The types of each file as a map.
+     */
+    [[nodiscard]]
+    pmr_expected_types_of_files_t identify_files(
+        const std::filesystem::path& directory, std::nothrow_t,
+        std::pmr::memory_resource* memory_resource,
+        std::filesystem::directory_options option = std::filesystem::directory_options::follow_directory_symlink
+    ) const noexcept
+    {
+        return identify_files_impl(
+            std::filesystem::recursive_directory_iterator{directory, option}, std::nothrow, memory_resource
+        );
+    }
+
     /**
      * @brief Identify the types of files.
      *
@@ -365,6 +599,72 @@ public:
         return identify_files_impl(files, std::nothrow);
     }
 
+    /**
+     * @brief Identify the types of files, continue after the files whose identification fails.
+     *
+     * @param[in] files             The container that holds the paths of the files.
+     *
+     * @returns The types of the identified files as a map, and the indexes of the other
+     *          files in the container with their errors, in the order of the container.
+     *
+     * @note No exception is thrown in the middle of the files, a failed file does not
+     *       discard the types of the files identified before it.
+     */
+    [[nodiscard]]
+    partial_types_of_files identify_files(
+        const file_concepts::file_container auto& files, continue_on_error_t
+    ) const noexcept
+    {
+        return identify_files_impl(files, continue_on_error);
+    }
+
+    /**
+     * @brief Identify the types of files, allocating the result from a memory resource.
+     *
+     * @param[in] files             The container that holds the paths of the files.
+     * @param[in] memory_resource   The memory resource of the map, its keys and its values.
+     *
+     * @returns The types of each file as a map.
+     *
+     * @throws magic_is_closed      if magic is closed.
+     * @throws empty_path           if the path of the file is empty.
+     * @throws magic_file_error     if identifying the type of the file fails.
+     *
+     * @note The result is released at once with a std::pmr::monotonic_buffer_resource.
+     */
+    [[nodiscard]]
+    pmr_types_of_files_t identify_files(
+        const file_concepts::file_container auto& files, std::pmr::memory_resource* memory_resource
+    ) const
+    {
+        return identify_files_impl(files, memory_resource);
+    }
+
+    /**
+     * @brief Identify the types of files, allocating the result from a memory resource, noexcept version.
+     *
+     * @param[in] files             The container that holds the paths of the files.
+     * @param[in] memory_resource   The memory resource of the map, its keys and its values.
+     *
+     * @returns The types of each file as a map.
+     */
+    [[nodiscard]]
+    pmr_expected_types_of_files_t identify_files(
+        const file_concepts::file_container auto& files, std::nothrow_t,
+        std::pmr::memory_resource* memory_resource
+    ) const noexcept
+    {
+        return identify_files_impl(files, std::nothrow, memory_resource);
+    }
+
+    /**
+     * @brief Used for testing whether the first bytes dispatch index is enabled.
+     *
+     * @returns True if the dispatch index is enabled, false otherwise.
+     */
+    [[nodiscard]]
+    bool is_dispatch_index_enabled() const noexcept;
+
     /**
      * @brief Used for testing whether magic is open or closed.
      *
@@ -373,6 +673,51 @@ public:
     [[nodiscard]]
     bool is_open() const noexcept;
 
+    /**
+     * @brief Used for testing whether the calls of magic are recorded.
+     *
+     * @returns True if the calls of magic are recorded, false otherwise.
+     */
+    [[nodiscard]]
+    bool is_recording() const noexcept;
+
+    /**
+     * @brief Used for testing whether the stages of the identifications are timed.
+     *
+     * @returns True if the stage timing is enabled, false otherwise.
+     */
+    [[nodiscard]]
+    bool is_stage_timing_enabled() const noexcept;
+
+    /**
+     * @brief Used for testing whether the statistics of the identifications are recorded.
+     *
+     * @returns True if the statistics are enabled and compiled in, false otherwise.
+     */
+    [[nodiscard]]
+    bool is_statistics_enabled() const noexcept;
+
+    /**
+     * @brief Used for testing whether the statistics of the identifications are recorded by type.
+     *
+     * @returns True if the type statistics are enabled, false otherwise.
+     */
+    [[nodiscard]]
+    bool is_type_statistics_enabled() const noexcept;
+
+    /**
+     * @brief Load a compiled magic database from memory.
+     *
+     * @param[in] database_buffer   The contents of a compiled (.mgc) magic database file.
+     *
+     * @throws magic_is_closed      if magic is closed.
+     * @throws magic_load_error     if loading the database buffer fails.
+     *
+     * @note magic keeps a copy of the database buffer, so the compiled databases embedded
+     *       by magicxx_add_database() are loaded without reading or parsing any file.
+     */
+    void load_database_buffer(std::span<const char> database_buffer);
+
     /**
      * @brief Load a magic database file.
      *
@@ -384,6 +729,9 @@ public:
      * @throws magic_load_error     if loading the database file fails.
      *
      * @note load_database_file() adds “.mgc” to the database filename as appropriate.
+     *
+     * @note When the compile cache is used, the cached compiled form of a database file
+     *       which has no compiled file is loaded, see set_compile_cache_directory().
      */
     void load_database_file(const std::filesystem::path& database_file = default_database_file);
 
@@ -409,6 +757,27 @@ public:
      */
     void open(const flags_container_t& flags_container);
 
+    /**
+     * @brief Zero the statistics of the identifications.
+     */
+    void reset_statistics() noexcept;
+
+    /**
+     * @brief Set the directory of the compile cache, which keeps the compiled forms of
+     *        the database files named by the hash of their contents.
+     *
+     * @param[in] cache_directory   The directory of the compile cache, an empty path disables the compile cache.
+     *
+     * @note When the compile cache is used, load_database_file() loads the cached compiled form of
+     *       a database file which has no compiled file, and compile() copies the cached compiled forms
+     *       of the database files, so each version of a database file is compiled only once.
+     *
+     * @note The key of a database file is the hash of its contents, or the names and
+     *       the contents of the files of a directory, and the version of the Magic Number
+     *       Recognition Library. The cache directory is created when needed.
+     */
+    void set_compile_cache_directory(const std::filesystem::path& cache_directory);
+
     /**
      * @brief Set the flags of magic.
      *
@@ -450,6 +819,41 @@ public:
      */
     void set_parameters(const parameter_value_map_t& parameters);
 
+    /**
+     * @brief Set the receiver of the spans of the identify_file(), load_database_file() and
+     *        load_database_buffer() calls of magic, including the calls made by identify_files().
+     *
+     * @param[in] span_tracer       The span tracer, nullptr to stop tracing the spans.
+     *
+     * @note The spans of the stages of the identifications, see identification_stage, are
+     *       nested in the spans of the calls if the stage timing is enabled. When no span tracer
+     *       is set, tracing costs a pointer test per call. trace::chrome_trace_writer writes the
+     *       spans to a file which is opened by Perfetto UI.
+     */
+    void set_span_tracer(std::shared_ptr<trace::span_tracer> span_tracer) noexcept;
+
+    /**
+     * @brief Record the identify_file(), load_database_file() and load_database_buffer() calls
+     *        of magic, including the calls made by identify_files(), into a trace file.
+     *
+     * @param[in] trace_file        The path of the trace file, its previous contents are removed.
+     * @param[in] prefix_size       The number of the first bytes of the identified files captured
+     *                              into the trace file, default is 0.
+     *
+     * @throws empty_path           if the path of the trace file is empty.
+     * @throws magic_trace_error    if the trace file can not be created.
+     *
+     * @note Each record holds the kind of the call, its input, the flags of magic, its start and
+     *       its duration, see magic_trace.hpp. The trace files are replayed by magicxx_replay.
+     *       A previous recording is stopped.
+     */
+    void start_recording(const std::filesystem::path& trace_file, std::size_t prefix_size = 0);
+
+    /**
+     * @brief Stop recording the calls of magic, and close the trace file.
+     */
+    void stop_recording() noexcept;
+
 private:
     class magic_private;
     std::unique_ptr<magic_private> m_impl;
@@ -458,7 +862,7 @@ private:
     types_of_files_t identify_files_impl(const std::ranges::range auto& files) const
     {
         types_of_files_t types_of_files;
-        std::ranges::for_each(files,
+        for_each_file(files,
             [&](const std::filesystem::path& file){
                 types_of_files[file] = identify_file(file);
             }
@@ -470,7 +874,7 @@ private:
     expected_types_of_files_t identify_files_impl(const std::ranges::range auto& files, std::nothrow_t) const noexcept
     {
         expected_types_of_files_t expected_types_of_files;
-        std::ranges::for_each(files,
+        for_each_file(files,
             [&](const std::filesystem::path& file){
                 expected_types_of_files[file] = identify_file(file, std::nothrow);
             }
@@ -478,6 +882,80 @@ private:
         return expected_types_of_files;
     }
 
+    [[nodiscard]]
+    partial_types_of_files identify_files_impl(const std::ranges::range auto& files, continue_on_error_t) const noexcept
+    {
+        partial_types_of_files partial_types_of_files;
+        std::size_t index{};
+        for_each_file(files,
+            [&](const std::filesystem::path& file){
+                auto expected_file_type = identify_file(file, std::nothrow);
+                if (expected_file_type){
+                    partial_types_of_files.types_of_files[file] = std::move(*expected_file_type);
+                } else {
+                    partial_types_of_files.errors.emplace_back(index, expected_file_type.error());
+                }
+                ++index;
+            }
+        );
+        return partial_types_of_files;
+    }
+
+    [[nodiscard]]
+    pmr_types_of_files_t identify_files_impl(
+        const std::ranges::range auto& files, std::pmr::memory_resource* memory_resource
+    ) const
+    {
+        pmr_types_of_files_t types_of_files{memory_resource};
+        for_each_file(files,
+            [&](const std::filesystem::path& file){
+                const auto file_type = identify_file(file);
+                types_of_files[std::pmr::string{file.native(), memory_resource}].assign(file_type);
+            }
+        );
+        return types_of_files;
+    }
+
+    [[nodiscard]]
+    pmr_expected_types_of_files_t identify_files_impl(
+        const std::ranges::range auto& files, std::nothrow_t, std::pmr::memory_resource* memory_resource
+    ) const noexcept
+    {
+        pmr_expected_types_of_files_t expected_types_of_files{memory_resource};
+        for_each_file(files,
+            [&](const std::filesystem::path& file){
+                const auto expected_file_type = identify_file(file, std::nothrow);
+                expected_types_of_files.insert_or_assign(
+                    std::pmr::string{file.native(), memory_resource},
+                    expected_file_type ?
+                    pmr_expected_file_type_t{std::in_place, *expected_file_type, memory_resource} :
+                    pmr_expected_file_type_t{std::unexpect, expected_file_type.error()}
+                );
+            }
+        );
+        return expected_types_of_files;
+    }
+
+    /**
+     * @brief Calls the function for each file, and records the traversal durations
+     *        if the stage timing is enabled.
+     */
+    void for_each_file(const std::ranges::range auto& files, auto&& function) const
+    {
+        if (!is_stage_timing_enabled()){
+            std::ranges::for_each(files, function);
+            return;
+        }
+        auto traversal_start = std::chrono::steady_clock::now();
+        for (const std::filesystem::path& file : files){
+            record_traversal(std::chrono::steady_clock::now() - traversal_start);
+            function(file);
+            traversal_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    void record_traversal(std::chrono::nanoseconds duration) const noexcept;
+
     friend std::string to_string(flags);
     friend std::string to_string(parameters);
 };
@@ -502,11 +980,12 @@ std::string to_string(
  * @brief Convert the magic::expected_file_type_t to string.
  *
  * @param[in] expected_file_type        The expected type of the file.
+ * @param[in] path                      The path of the file used in the error message, default is empty.
  *
  * @returns The expected_file_type as a string.
  */
 [[nodiscard]]
-std::string to_string(const magic::expected_file_type_t& expected_file_type);
+std::string to_string(const magic::expected_file_type_t& expected_file_type, const std::filesystem::path& path = {});
 
 /**
  * @brief Convert the magic::expected_types_of_files_t to string.
@@ -524,6 +1003,82 @@ std::string to_string(
     const std::string& file_separator = "\n"
 );
 
+/**
+ * @brief Write the magic::types_of_files_t to a stream, in the format of to_string().
+ *
+ * @param[in] stream                    The output stream.
+ * @param[in] types_of_files            The types of each file.
+ * @param[in] type_separator            The separator between the file and its type, default is " -> ".
+ * @param[in] file_separator            The separator between the files, default is "\n".
+ *
+ * @returns The stream.
+ *
+ * @note The files are written in chunks of 64 KiB, without building the whole string.
+ */
+std::ostream& write_to(
+    std::ostream& stream,
+    const magic::types_of_files_t& types_of_files,
+    const std::string& type_separator = " -> ",
+    const std::string& file_separator = "\n"
+);
+
+/**
+ * @brief Write the magic::expected_types_of_files_t to a stream, in the format of to_string().
+ *
+ * @param[in] stream                    The output stream.
+ * @param[in] expected_types_of_files   The expected types of each file.
+ * @param[in] type_separator            The separator between the file and its expected type, default is " -> ".
+ * @param[in] file_separator            The separator between the files, default is "\n".
+ *
+ * @returns The stream.
+ *
+ * @note The files are written in chunks of 64 KiB, without building the whole string.
+ */
+std::ostream& write_to(
+    std::ostream& stream,
+    const magic::expected_types_of_files_t& expected_types_of_files,
+    const std::string& type_separator = " -> ",
+    const std::string& file_separator = "\n"
+);
+
+/**
+ * @brief Write the magic::types_of_files_t to a file descriptor, in the format of to_string().
+ *
+ * @param[in] file_descriptor           The file descriptor, such as STDOUT_FILENO.
+ * @param[in] types_of_files            The types of each file.
+ * @param[in] type_separator            The separator between the file and its type, default is " -> ".
+ * @param[in] file_separator            The separator between the files, default is "\n".
+ *
+ * @returns True if all files are written, false otherwise.
+ *
+ * @note The files are written in chunks of 64 KiB, without building the whole string.
+ */
+bool write_to(
+    int file_descriptor,
+    const magic::types_of_files_t& types_of_files,
+    const std::string& type_separator = " -> ",
+    const std::string& file_separator = "\n"
+);
+
+/**
+ * @brief Write the magic::expected_types_of_files_t to a file descriptor, in the format of to_string().
+ *
+ * @param[in] file_descriptor           The file descriptor, such as STDOUT_FILENO.
+ * @param[in] expected_types_of_files   The expected types of each file.
+ * @param[in] type_separator            The separator between the file and its expected type, default is " -> ".
+ * @param[in] file_separator            The separator between the files, default is "\n".
+ *
+ * @returns True if all files are written, false otherwise.
+ *
+ * @note The files are written in chunks of 64 KiB, without building the whole string.
+ */
+bool write_to(
+    int file_descriptor,
+    const magic::expected_types_of_files_t& expected_types_of_files,
+    const std::string& type_separator = " -> ",
+    const std::string& file_separator = "\n"
+);
+
 /**
  * @brief Convert the magic::flags to string.
  * 
@@ -573,4 +1128,69 @@ std::string to_string(
 
 } /* namespace recognition */
 
+/**
+ * @brief Formats the magic::flags as to_string() converts them.
+ */
+template <>
+struct std::formatter<recognition::magic::flags> : std::formatter<std::string_view> {
+    auto format(recognition::magic::flags flag, std::format_context& context) const
+    {
+        return std::formatter<std::string_view>::format(recognition::to_string(flag), context);
+    }
+};
+
+/**
+ * @brief Formats the magic::parameters as to_string() converts them.
+ */
+template <>
+struct std::formatter<recognition::magic::parameters> : std::formatter<std::string_view> {
+    auto format(recognition::magic::parameters parameter, std::format_context& context) const
+    {
+        return std::formatter<std::string_view>::format(recognition::to_string(parameter), context);
+    }
+};
+
+/**
+ * @brief Formats the magic::expected_file_type_t as to_string() converts it.
+ */
+template <>
+struct std::formatter<recognition::magic::expected_file_type_t> : std::formatter<std::string_view> {
+    auto format(const recognition::magic::expected_file_type_t& expected_file_type, std::format_context& context) const
+    {
+        if (expected_file_type){
+            return std::formatter<std::string_view>::format(*expected_file_type, context);
+        }
+        return std::formatter<std::string_view>::format(expected_file_type.error().message(), context);
+    }
+};
+
+/**
+ * @brief Formats the magic::partial_types_of_files as the types of the files
+ *        followed by the indexes of the failed files with their errors.
+ *
+ * @throws std::format_error    if the format specification is not empty.
+ */
+template <>
+struct std::formatter<recognition::magic::partial_types_of_files> {
+    constexpr auto parse(std::format_parse_context& context)
+    {
+        if (context.begin() != context.end() && *context.begin() != '}'){
+            throw std::format_error{"The format specification of magic::partial_types_of_files must be empty."};
+        }
+        return context.begin();
+    }
+
+    auto format(const recognition::magic::partial_types_of_files& partial_types_of_files, std::format_context& context) const
+    {
+        auto out = context.out();
+        for (const auto& [file, file_type] : partial_types_of_files.types_of_files){
+            out = std::format_to(out, "{} -> {}\n", file.string(), file_type);
+        }
+        for (const auto& [index, error] : partial_types_of_files.errors){
+            out = std::format_to(out, "#{} -> {}\n", index, error.message());
+        }
+        return out;
+    }
+};
+
 #endif /* MAGIC_HPP */
@@ -0,0 +1,152 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_ERROR_HPP
+#define MAGIC_ERROR_HPP
+
+#include <array>
+#include <format>
+#include <memory>
+#include <string>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+namespace recognition {
+
+/**
+ * @brief The magic_errc enums are the error codes of the noexcept identifications,
+ *        named after the exceptions thrown by the throwing versions.
+ */
+enum class magic_errc : int {
+    magic_is_closed  = 1, /**< Magic is closed. */
+    empty_path       = 2, /**< The path of the file is empty. */
+    magic_file_error = 3  /**< libmagic failed to identify the file. */
+};
+
+/**
+ * @brief Get the error category of the magic_errc enums, whose name is "magic".
+ */
+[[nodiscard]]
+const std::error_category& magic_category() noexcept;
+
+/**
+ * @brief Make an std::error_code from a magic_errc enum.
+ */
+[[nodiscard]]
+std::error_code make_error_code(magic_errc errc) noexcept;
+
+/**
+ * @class magic_error
+ *
+ * @brief The magic_error class is the error of a noexcept identification, an error code,
+ *        the errno and the description reported by libmagic, whose message is formatted on demand.
+ *
+ * @note The descriptions up to inline_description_capacity characters are stored inline, so
+ *       creating a magic_error with one does not allocate memory, a longer description is
+ *       allocated once and shared by the copies of the error.
+ */
+class magic_error {
+public:
+
+    /**
+     * @brief The length of the longest description stored inline in the magic_error.
+     */
+    static constexpr std::size_t inline_description_capacity{96};
+
+    /**
+     * @brief Construct magic_error.
+     *
+     * @param[in] errc              The error code.
+     * @param[in] error_number      The errno reported by libmagic, default is 0.
+     */
+    constexpr explicit magic_error(magic_errc errc, int error_number = 0) noexcept
+        : m_errc{errc},
+          m_error_number{error_number}
+    { }
+
+    /**
+     * @brief Construct magic_error with the description reported by libmagic.
+     *
+     * @param[in] errc              The error code.
+     * @param[in] error_number      The errno reported by libmagic.
+     * @param[in] description       The description reported by libmagic, such as
+     *                              "cannot open `path' (No such file or directory)".
+     *
+     * @note The description is dropped if it is empty, or if it is longer than
+     *       inline_description_capacity and can not be allocated.
+     */
+    magic_error(magic_errc errc, int error_number, std::string_view description) noexcept;
+
+    /**
+     * @brief Get the error code.
+     */
+    [[nodiscard]]
+    constexpr magic_errc code() const noexcept
+    {
+        return m_errc;
+    }
+
+    /**
+     * @brief Get the errno reported by libmagic, 0 if libmagic did not report one.
+     */
+    [[nodiscard]]
+    constexpr int error_number() const noexcept
+    {
+        return m_error_number;
+    }
+
+    /**
+     * @brief Get the description reported by libmagic, empty if libmagic did not report one.
+     */
+    [[nodiscard]]
+    std::string_view description() const noexcept
+    {
+        return m_description ? std::string_view{*m_description} :
+               std::string_view{m_inline_description.data(), m_inline_description_size};
+    }
+
+    /**
+     * @brief Format the message of the error, like the what() of the exception thrown
+     *        by the throwing version.
+     *
+     * @param[in] path              The path of the file, default is empty.
+     *
+     * @returns The message, such as "magic_file(path) failed with cannot open `path'
+     *          (No such file or directory).", or the message of the errno if libmagic
+     *          did not report a description.
+     */
+    [[nodiscard]]
+    std::string message(const std::filesystem::path& path = {}) const;
+
+    friend bool operator==(const magic_error& first, const magic_error& second) noexcept
+    {
+        return first.m_errc == second.m_errc && first.m_error_number == second.m_error_number &&
+               first.description() == second.description();
+    }
+
+private:
+    magic_errc m_errc;
+    int m_error_number;
+    std::shared_ptr<const std::string> m_description;
+    std::size_t m_inline_description_size{};
+    std::array<char, inline_description_capacity> m_inline_description{};
+};
+
+} /* namespace recognition */
+
+template <>
+struct std::is_error_code_enum<recognition::magic_errc> : std::true_type { };
+
+/**
+ * @brief Formats the magic_error as its message without the path.
+ */
+template <>
+struct std::formatter<recognition::magic_error> : std::formatter<std::string_view> {
+    auto format(const recognition::magic_error& error, std::format_context& context) const
+    {
+        return std::formatter<std::string_view>::format(error.message(), context);
+    }
+};
+
+#endif /* MAGIC_ERROR_HPP */
@@ -98,6 +98,27 @@ public:
     { }
 };
 
+class magic_trace_error final : public magic_exception {
+public:
+    magic_trace_error(const std::string& error, const std::string& trace_file_path)
+        : magic_exception{"magic_trace(" + trace_file_path + ")", error}
+    { }
+};
+
+class magic_output_error final : public magic_exception {
+public:
+    magic_output_error(const std::string& error, const std::string& output_file_path)
+        : magic_exception{"magic_output(" + output_file_path + ")", error}
+    { }
+};
+
+class magic_results_error final : public magic_exception {
+public:
+    magic_results_error(const std::string& error, const std::string& results_file_path)
+        : magic_exception{"magic_results(" + results_file_path + ")", error}
+    { }
+};
+
 } /* namespace recognition */
 
 #endif /* MAGIC_EXCEPTION_HPP */
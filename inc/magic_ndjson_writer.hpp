@@ -0,0 +1,155 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_NDJSON_WRITER_HPP
+#define MAGIC_NDJSON_WRITER_HPP
+
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+
+#include <magic.hpp>
+
+namespace recognition {
+
+/**
+ * @class ndjson_writer
+ *
+ * @brief The ndjson_writer class writes the types of files as newline-delimited JSON records,
+ *        {"path":..., "type":..., "mime":..., "error":..., "size":...}, one per line.
+ *
+ * @note The type and the mime are null if they are not identified, the error is null if
+ *       the identification succeeded, and the size is null if the file is not a regular file.
+ *       The bytes of the paths that are not valid UTF-8 are escaped as the lone surrogates
+ *       U+DC80 to U+DCFF. The records are buffered and written in chunks of 64 KiB, so the
+ *       memory used by the writer is constant. The writer is thread-safe.
+ */
+class ndjson_writer {
+public:
+
+    /**
+     * @brief Construct ndjson_writer, create the output file.
+     *
+     * @param[in] output_file       The path of the output file, its previous contents are removed.
+     *
+     * @throws magic_output_error   if the output file can not be created.
+     */
+    explicit ndjson_writer(const std::filesystem::path& output_file);
+
+    /**
+     * @brief Construct ndjson_writer writing to a file descriptor, such as a pipe.
+     *
+     * @param[in] file_descriptor   The file descriptor, which is not closed by the writer.
+     */
+    explicit ndjson_writer(int file_descriptor) noexcept;
+
+    ndjson_writer(const ndjson_writer&) = delete;
+
+    ndjson_writer& operator=(const ndjson_writer&) = delete;
+
+    /**
+     * @brief Destruct ndjson_writer, write the buffered records and close the output file.
+     */
+    ~ndjson_writer();
+
+    /**
+     * @brief Write the buffered records.
+     *
+     * @returns True if all records have been written so far, false otherwise.
+     */
+    bool flush() noexcept;
+
+    /**
+     * @brief Used for testing whether all records have been written so far.
+     *
+     * @returns False if writing to the output failed, true otherwise.
+     */
+    [[nodiscard]]
+    bool good() const noexcept;
+
+    /**
+     * @brief Identify the type of a file, and write its record.
+     *
+     * @param[in] type_magic        The magic identifying the type of the file.
+     * @param[in] path              The path of the file.
+     * @param[in] mime_magic        The magic identifying the MIME type of the file, default is nullptr,
+     *                              in which case the mime is null.
+     */
+    void identify_file(const magic& type_magic, const std::filesystem::path& path, const magic* mime_magic = nullptr) noexcept;
+
+    /**
+     * @brief Identify the types of all files in a directory, and write their records.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] directory         The path of the directory.
+     * @param[in] mime_magic        The magic identifying the MIME types of the files, default is nullptr.
+     * @param[in] option            The directory iteration option, default is follow_directory_symlink.
+     *
+     * @throws std::filesystem::filesystem_error    if iterating the directory fails.
+     */
+    void identify_files(
+        const magic& type_magic, const std::filesystem::path& directory,
+        const magic* mime_magic = nullptr,
+        std::filesystem::directory_options option = std::filesystem::directory_options::follow_directory_symlink
+    )
+    {
+        for (const std::filesystem::path& file : std::filesystem::recursive_directory_iterator{directory, option}){
+            identify_file(type_magic, file, mime_magic);
+        }
+    }
+
+    /**
+     * @brief Identify the types of files, and write their records.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] files             The container that holds the paths of the files.
+     * @param[in] mime_magic        The magic identifying the MIME types of the files, default is nullptr.
+     */
+    void identify_files(
+        const magic& type_magic, const file_concepts::file_container auto& files,
+        const magic* mime_magic = nullptr
+    ) noexcept
+    {
+        for (const auto& file : files){
+            identify_file(type_magic, file, mime_magic);
+        }
+    }
+
+    /**
+     * @brief Get the number of the records written.
+     */
+    [[nodiscard]]
+    std::size_t record_count() const noexcept;
+
+    /**
+     * @brief Write a record.
+     *
+     * @param[in] path              The path of the file.
+     * @param[in] file_type         The expected type of the file.
+     * @param[in] mime              The expected MIME type of the file, default is nullptr,
+     *                              in which case the mime is null.
+     * @param[in] size              The size of the file, default is null.
+     */
+    void write(
+        const std::filesystem::path& path,
+        const magic::expected_file_type_t& file_type,
+        const magic::expected_file_type_t* mime = nullptr,
+        std::optional<std::uintmax_t> size = std::nullopt
+    ) noexcept;
+
+private:
+    int m_file_descriptor;
+    bool m_owns_file_descriptor;
+    bool m_good{true};
+    std::size_t m_record_count{};
+    std::string m_buffer;
+    mutable std::mutex m_mutex;
+
+    bool flush_buffer() noexcept;
+};
+
+} /* namespace recognition */
+
+#endif /* MAGIC_NDJSON_WRITER_HPP */
@@ -0,0 +1,209 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_PATH_STORE_HPP
+#define MAGIC_PATH_STORE_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include <magic.hpp>
+
+namespace recognition {
+
+/**
+ * @class path_store
+ *
+ * @brief The path_store class stores paths as the nodes of a directory trie, each node holds
+ *        the id of its parent and its name in an arena, so the common prefixes of the paths
+ *        are stored once, and a path is rebuilt from its id on demand.
+ *
+ * @note The id of a path is the id of the node of its last component, 0 is the id of the
+ *       empty path. Inserting a path that is already stored returns its id, the paths are
+ *       rebuilt exactly as they are inserted. A node takes 12 bytes and a slot of the hash
+ *       table used for finding the children of the nodes.
+ */
+class path_store {
+public:
+
+    /**
+     * @brief The path_id_t typedef.
+     */
+    using path_id_t = std::uint32_t;
+
+    /**
+     * @brief The id of the empty path.
+     */
+    static constexpr path_id_t empty_path_id{0};
+
+    /**
+     * @brief Construct path_store holding the empty path.
+     */
+    path_store();
+
+    /**
+     * @brief Get the path of an id.
+     *
+     * @throws std::out_of_range    if path_id is not less than size().
+     */
+    [[nodiscard]]
+    std::filesystem::path get_path(path_id_t path_id) const;
+
+    /**
+     * @brief Insert a path, and the directories containing it.
+     *
+     * @param[in] path              The path.
+     *
+     * @returns The id of the path.
+     *
+     * @throws std::length_error    if the number of the nodes exceeds the range of path_id_t.
+     */
+    path_id_t insert(const std::filesystem::path& path);
+
+    /**
+     * @brief Get the approximate number of bytes held by the path store.
+     */
+    [[nodiscard]]
+    std::size_t memory_usage() const noexcept;
+
+    /**
+     * @brief Get the number of the nodes, the ids of the paths are less than the number of the nodes.
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept;
+
+private:
+    struct node_t {
+        path_id_t parent;
+        std::uint32_t name_offset;
+        std::uint32_t name_size;
+    };
+
+    std::string m_names;
+    std::vector<node_t> m_nodes;
+    std::vector<path_id_t> m_children;
+
+    [[nodiscard]]
+    std::string_view get_name(path_id_t path_id) const noexcept;
+
+    path_id_t insert_child(path_id_t parent, std::string_view name);
+
+    void grow_children();
+};
+
+/**
+ * @class compact_types_of_files
+ *
+ * @brief The compact_types_of_files class holds the types of files like magic::types_of_files_t,
+ *        with the paths in a path_store and the types interned, in the order of insertion.
+ */
+class compact_types_of_files {
+public:
+
+    /**
+     * @brief The type_id_t typedef.
+     */
+    using type_id_t = std::uint32_t;
+
+    /**
+     * @brief The entry_t struct holds the ids of the path and the type of a file.
+     */
+    struct entry_t {
+        path_store::path_id_t path_id;
+        type_id_t type_id;
+    };
+
+    /**
+     * @brief Get the entries in the order of insertion.
+     */
+    [[nodiscard]]
+    const std::vector<entry_t>& entries() const noexcept;
+
+    /**
+     * @brief Get the path of the entry at index.
+     */
+    [[nodiscard]]
+    std::filesystem::path get_path(std::size_t index) const;
+
+    /**
+     * @brief Get the path store.
+     */
+    [[nodiscard]]
+    const path_store& get_path_store() const noexcept;
+
+    /**
+     * @brief Get the type of the entry at index.
+     */
+    [[nodiscard]]
+    std::string_view get_type(std::size_t index) const;
+
+    /**
+     * @brief Get the interned types in the order of their ids.
+     */
+    [[nodiscard]]
+    const std::vector<std::string_view>& get_types() const noexcept;
+
+    /**
+     * @brief Identify the types of files, and insert the types of the identified files.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] files             The container that holds the paths of the files.
+     *
+     * @returns The indexes of the files in the container whose identification failed, with their errors.
+     */
+    magic::file_errors_t identify_files(const magic& type_magic, const file_concepts::file_container auto& files)
+    {
+        magic::file_errors_t errors;
+        std::size_t index{};
+        for (const auto& file : files){
+            auto expected_file_type = type_magic.identify_file(file, std::nothrow);
+            if (expected_file_type){
+                insert(file, *expected_file_type);
+            } else {
+                errors.emplace_back(index, expected_file_type.error());
+            }
+            ++index;
+        }
+        return errors;
+    }
+
+    /**
+     * @brief Insert the type of a file.
+     *
+     * @param[in] path              The path of the file.
+     * @param[in] file_type         The type of the file.
+     */
+    void insert(const std::filesystem::path& path, std::string_view file_type);
+
+    /**
+     * @brief Get the approximate number of bytes held by the types of files.
+     */
+    [[nodiscard]]
+    std::size_t memory_usage() const noexcept;
+
+    /**
+     * @brief Get the number of the entries.
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Convert to magic::types_of_files_t, rebuilding the paths.
+     */
+    [[nodiscard]]
+    magic::types_of_files_t to_types_of_files() const;
+
+private:
+    path_store m_paths;
+    std::vector<entry_t> m_entries;
+    std::vector<std::string_view> m_types;
+    std::map<std::string, type_id_t, std::less<>> m_type_ids;
+};
+
+} /* namespace recognition */
+
+#endif /* MAGIC_PATH_STORE_HPP */
@@ -0,0 +1,287 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_RESULTS_HPP
+#define MAGIC_RESULTS_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <expected>
+#include <functional>
+#include <filesystem>
+#include <string_view>
+
+#include <magic.hpp>
+
+namespace recognition::results {
+
+/**
+ * @brief The record struct describes the result of the identification of a file.
+ */
+struct record {
+    std::filesystem::path path;                         /**< The path of the file. */
+    std::expected<std::string_view, magic_error> type;  /**< The type of the file, or the error. */
+    std::optional<std::uint64_t> size;                  /**< The size of the file, if it is a regular file. */
+};
+
+/**
+ * @class writer
+ *
+ * @brief The writer class writes the types of files to a compact binary columnar results file.
+ *
+ * @note The records are written in blocks of block_size records, each block holds the front
+ *       coded paths with a restart point every restart_interval paths, the codes of the types,
+ *       the errors and the sizes as separate columns. The types are interned in a dictionary
+ *       written at the end of the file with the offsets of the blocks, so the memory used by
+ *       the writer is bounded by a block and the distinct types. The descriptions of the errors
+ *       reported by libmagic are interned in a second dictionary, and the type code of a failed
+ *       record is the code of its description.
+ */
+class writer {
+public:
+
+    /**
+     * @brief Construct writer, create the results file.
+     *
+     * @param[in] results_file      The path of the results file, its previous contents are removed.
+     *
+     * @throws magic_results_error  if the results file can not be created.
+     */
+    explicit writer(const std::filesystem::path& results_file);
+
+    writer(const writer&) = delete;
+
+    writer& operator=(const writer&) = delete;
+
+    /**
+     * @brief Destruct writer, close the results file if it is not closed.
+     */
+    ~writer();
+
+    /**
+     * @brief Write the last block and the dictionary, and close the results file.
+     *
+     * @throws magic_results_error  if writing the results file fails.
+     */
+    void close();
+
+    /**
+     * @brief Get the path of the results file.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& file() const noexcept;
+
+    /**
+     * @brief Identify the type of a file, and write its record.
+     *
+     * @param[in] type_magic        The magic identifying the type of the file.
+     * @param[in] path              The path of the file.
+     *
+     * @throws magic_results_error  if writing the results file fails.
+     */
+    void identify_file(const magic& type_magic, const std::filesystem::path& path);
+
+    /**
+     * @brief Identify the types of all files in a directory, and write their records.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] directory         The path of the directory.
+     * @param[in] option            The directory iteration option, default is follow_directory_symlink.
+     *
+     * @throws magic_results_error                  if writing the results file fails.
+     * @throws std::filesystem::filesystem_error    if iterating the directory fails.
+     */
+    void identify_files(
+        const magic& type_magic, const std::filesystem::path& directory,
+        std::filesystem::directory_options option = std::filesystem::directory_options::follow_directory_symlink
+    )
+    {
+        for (const std::filesystem::path& file : std::filesystem::recursive_directory_iterator{directory, option}){
+            identify_file(type_magic, file);
+        }
+    }
+
+    /**
+     * @brief Identify the types of files, and write their records.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] files             The container that holds the paths of the files.
+     *
+     * @throws magic_results_error  if writing the results file fails.
+     */
+    void identify_files(const magic& type_magic, const file_concepts::file_container auto& files)
+    {
+        for (const auto& file : files){
+            identify_file(type_magic, file);
+        }
+    }
+
+    /**
+     * @brief Get the number of the records written.
+     */
+    [[nodiscard]]
+    std::size_t record_count() const noexcept;
+
+    /**
+     * @brief Write a record.
+     *
+     * @param[in] path              The path of the file.
+     * @param[in] file_type         The expected type of the file.
+     * @param[in] size              The size of the file, default is null.
+     *
+     * @throws magic_results_error  if the results file is closed or writing it fails.
+     */
+    void write(
+        const std::filesystem::path& path,
+        const magic::expected_file_type_t& file_type,
+        std::optional<std::uint64_t> size = std::nullopt
+    );
+
+private:
+    std::filesystem::path m_file;
+    std::ofstream m_stream;
+    std::uint64_t m_offset{};
+    std::size_t m_record_count{};
+    std::string m_previous_path;
+    std::string m_paths;
+    std::vector<std::uint32_t> m_restarts;
+    std::vector<std::uint32_t> m_type_codes;
+    std::vector<std::uint32_t> m_errors;
+    std::vector<std::uint64_t> m_sizes;
+    std::vector<std::uint64_t> m_block_offsets;
+    std::vector<std::string_view> m_types;
+    std::map<std::string, std::uint32_t, std::less<>> m_type_codes_by_type;
+    std::vector<std::string_view> m_descriptions;
+    std::map<std::string, std::uint32_t, std::less<>> m_description_codes_by_description;
+
+    void write_block();
+
+    void write_bytes(std::string_view bytes);
+};
+
+/**
+ * @class reader
+ *
+ * @brief The reader class maps a results file into memory, and reads its records
+ *        without deserialising the whole file.
+ *
+ * @note Opening a results file reads its dictionary and the headers of its blocks, a record
+ *       is decoded on demand by decoding at most restart_interval paths of its block. Finding
+ *       the records of a type compares the types of the dictionary and scans the type codes.
+ */
+class reader {
+public:
+
+    /**
+     * @brief Construct reader, map the results file into memory.
+     *
+     * @param[in] results_file      The path of the results file.
+     *
+     * @throws magic_results_error  if the results file can not be read or is malformed.
+     */
+    explicit reader(const std::filesystem::path& results_file);
+
+    reader(reader&& other) noexcept;
+
+    reader(const reader&) = delete;
+
+    reader& operator=(reader&& other) noexcept;
+
+    reader& operator=(const reader&) = delete;
+
+    /**
+     * @brief Destruct reader, unmap the results file.
+     */
+    ~reader();
+
+    /**
+     * @brief Get the record at index.
+     *
+     * @throws std::out_of_range    if index is not less than size().
+     */
+    [[nodiscard]]
+    record at(std::size_t index) const;
+
+    /**
+     * @brief Find the indexes of the records whose type is type.
+     */
+    [[nodiscard]]
+    std::vector<std::size_t> find(std::string_view type) const;
+
+    /**
+     * @brief Find the indexes of the records whose type satisfies the predicate,
+     *        the predicate is called once for each type of the dictionary.
+     */
+    [[nodiscard]]
+    std::vector<std::size_t> find_if(const std::function<bool(std::string_view)>& predicate) const;
+
+    /**
+     * @brief Call the function with the index and the type of each record whose type is
+     *        identified, in the order of the records, without decoding the paths.
+     */
+    void for_each_type(const std::function<void(std::size_t, std::string_view)>& function) const;
+
+    /**
+     * @brief Get the number of the records.
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Get the distinct types of the records in the order of their codes.
+     */
+    [[nodiscard]]
+    const std::vector<std::string_view>& types() const noexcept;
+
+private:
+    struct block_t {
+        std::size_t first;
+        std::size_t count;
+        const char* restarts;
+        const char* paths;
+        std::size_t paths_size;
+        const char* type_codes;
+        const char* errors;
+        const char* sizes;
+    };
+
+    const char* m_data{nullptr};
+    std::size_t m_size{};
+    std::size_t m_record_count{};
+    std::vector<std::string_view> m_types;
+    std::vector<std::string_view> m_descriptions;
+    std::vector<block_t> m_blocks;
+
+    void parse(const std::filesystem::path& results_file);
+
+    [[nodiscard]]
+    std::vector<std::size_t> find_codes(const std::vector<bool>& matching_codes) const;
+};
+
+/**
+ * @brief The signature of the results files.
+ */
+inline constexpr std::string_view signature{"MAGICXXR"};
+
+/**
+ * @brief The format version of the results and the type index files.
+ */
+inline constexpr std::uint8_t version{2};
+
+/**
+ * @brief The number of the records of a block.
+ */
+inline constexpr std::size_t block_size{4096};
+
+/**
+ * @brief The number of the front coded paths between the restart points, which are stored whole.
+ */
+inline constexpr std::size_t restart_interval{16};
+
+} /* namespace recognition::results */
+
+#endif /* MAGIC_RESULTS_HPP */
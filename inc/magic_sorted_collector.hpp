@@ -0,0 +1,209 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_SORTED_COLLECTOR_HPP
+#define MAGIC_SORTED_COLLECTOR_HPP
+
+#include <string>
+#include <vector>
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <string_view>
+
+#include <magic.hpp>
+#include <magic_results.hpp>
+
+namespace recognition::results {
+
+/**
+ * @class sorted_collector
+ *
+ * @brief The sorted_collector class collects the types of files in any order, and merges
+ *        them into a stream of records sorted by their paths, like the types_of_files_t,
+ *        using a bounded amount of memory regardless of the number of the files.
+ *
+ * @note The records are accumulated in memory until they exceed the memory budget, then
+ *       they are sorted and spilled to a run file in the temporary directory. Merging reads
+ *       the runs and the records in memory with a k-way merge, merging at most merge_width
+ *       runs at once. The paths are ordered like std::filesystem::path, element by element,
+ *       and the last record collected for a path replaces the previous ones. The run files
+ *       are removed when the collector is destroyed.
+ */
+class sorted_collector {
+public:
+
+    /**
+     * @brief Construct sorted_collector.
+     *
+     * @param[in] memory_budget         The number of bytes of the records held in memory before
+     *                                  they are spilled, default is default_memory_budget.
+     * @param[in] temporary_directory   The directory of the run files, default is the temporary
+     *                                  directory of the system.
+     */
+    explicit sorted_collector(
+        std::size_t memory_budget = default_memory_budget,
+        const std::filesystem::path& temporary_directory = std::filesystem::temp_directory_path()
+    );
+
+    sorted_collector(const sorted_collector&) = delete;
+
+    sorted_collector& operator=(const sorted_collector&) = delete;
+
+    /**
+     * @brief Destruct sorted_collector, remove the run files.
+     */
+    ~sorted_collector();
+
+    /**
+     * @brief Call the function with each record in the order of their paths.
+     *
+     * @param[in] function          The function called with each record, the type of the
+     *                              record is valid until the function returns.
+     *
+     * @throws magic_output_error   if reading or writing a run file fails.
+     */
+    void for_each(const std::function<void(const record&)>& function);
+
+    /**
+     * @brief Identify the type of a file, and collect its record.
+     *
+     * @param[in] type_magic        The magic identifying the type of the file.
+     * @param[in] path              The path of the file.
+     *
+     * @throws magic_output_error   if spilling the records fails.
+     */
+    void identify_file(const magic& type_magic, const std::filesystem::path& path);
+
+    /**
+     * @brief Identify the types of all files in a directory, and collect their records.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] directory         The path of the directory.
+     * @param[in] option            The directory iteration option, default is follow_directory_symlink.
+     *
+     * @throws magic_output_error                   if spilling the records fails.
+     * @throws std::filesystem::filesystem_error    if iterating the directory fails.
+     */
+    void identify_files(
+        const magic& type_magic, const std::filesystem::path& directory,
+        std::filesystem::directory_options option = std::filesystem::directory_options::follow_directory_symlink
+    )
+    {
+        for (const std::filesystem::path& file : std::filesystem::recursive_directory_iterator{directory, option}){
+            identify_file(type_magic, file);
+        }
+    }
+
+    /**
+     * @brief Identify the types of files, and collect their records.
+     *
+     * @param[in] type_magic        The magic identifying the types of the files.
+     * @param[in] files             The container that holds the paths of the files.
+     *
+     * @throws magic_output_error   if spilling the records fails.
+     */
+    void identify_files(const magic& type_magic, const file_concepts::file_container auto& files)
+    {
+        for (const auto& file : files){
+            identify_file(type_magic, file);
+        }
+    }
+
+    /**
+     * @brief Collect a record.
+     *
+     * @param[in] path              The path of the file.
+     * @param[in] file_type         The expected type of the file.
+     * @param[in] size              The size of the file, default is null.
+     *
+     * @throws magic_output_error   if spilling the records fails.
+     */
+    void insert(
+        const std::filesystem::path& path,
+        const magic::expected_file_type_t& file_type,
+        std::optional<std::uint64_t> size = std::nullopt
+    );
+
+    /**
+     * @brief Get the number of the bytes of the records held in memory.
+     */
+    [[nodiscard]]
+    std::size_t memory_usage() const noexcept;
+
+    /**
+     * @brief Get the number of the records collected, including the replaced ones.
+     */
+    [[nodiscard]]
+    std::size_t record_count() const noexcept;
+
+    /**
+     * @brief Get the number of the run files.
+     */
+    [[nodiscard]]
+    std::size_t run_count() const noexcept;
+
+    /**
+     * @brief Write the records in the order of their paths to a results file.
+     *
+     * @param[in] results_writer    The writer of the results file.
+     *
+     * @throws magic_output_error   if reading or writing a run file fails.
+     * @throws magic_results_error  if writing the results file fails.
+     */
+    void write(writer& results_writer);
+
+    /**
+     * @brief The default memory budget, 256 MiB.
+     */
+    static constexpr std::size_t default_memory_budget{256 * 1024 * 1024};
+
+    /**
+     * @brief The maximum number of the runs merged at once, the runs beyond it are merged
+     *        into intermediate runs first.
+     */
+    static constexpr std::size_t merge_width{64};
+
+private:
+    struct entry_t {
+        std::size_t offset;
+        std::uint32_t path_size;
+        std::uint32_t type_size;
+        std::uint32_t error;
+        std::uint64_t size;
+    };
+
+    std::size_t m_memory_budget;
+    std::filesystem::path m_temporary_directory;
+    std::size_t m_collector_id;
+    std::size_t m_record_count{};
+    std::size_t m_next_run{};
+    std::string m_bytes;
+    std::vector<entry_t> m_entries;
+    std::vector<std::filesystem::path> m_runs;
+
+    [[nodiscard]]
+    std::string_view get_path(const entry_t& entry) const noexcept;
+
+    void sort_entries();
+
+    void spill();
+
+    void merge_runs();
+
+    [[nodiscard]]
+    std::filesystem::path make_run_path();
+};
+
+/**
+ * @brief Compare two native paths element by element, like std::filesystem::path::compare(),
+ *        without constructing the paths.
+ */
+[[nodiscard]]
+std::strong_ordering compare_paths(std::string_view first, std::string_view second) noexcept;
+
+} /* namespace recognition::results */
+
+#endif /* MAGIC_SORTED_COLLECTOR_HPP */
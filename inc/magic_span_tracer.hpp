@@ -0,0 +1,112 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_SPAN_TRACER_HPP
+#define MAGIC_SPAN_TRACER_HPP
+
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+
+namespace recognition::trace {
+
+/**
+ * @class span_tracer
+ *
+ * @brief The span_tracer class is the interface of the receivers of the spans of the calls
+ *        of a magic and of the stages of its identifications.
+ *
+ * @note The spans of a thread are properly nested, each begin() is followed by the end() of
+ *       the same span, after the begin() and end() calls of its nested spans. The spans of the
+ *       traversal stage of identify_files() are reported after they end, with their past times.
+ *       A span_tracer shared by the magics of different threads must be thread-safe.
+ */
+class span_tracer {
+public:
+
+    /**
+     * @brief The clock_t typedef, the clock of the times of the spans.
+     */
+    using clock_t = std::chrono::steady_clock;
+
+    virtual ~span_tracer() = default;
+
+    /**
+     * @brief Called when a span begins.
+     *
+     * @param[in] name              The name of the call or the stage.
+     * @param[in] detail            The path of the file or the database file, may be empty.
+     * @param[in] time              The time when the span began.
+     */
+    virtual void begin(std::string_view name, std::string_view detail, clock_t::time_point time) noexcept = 0;
+
+    /**
+     * @brief Called when a span ends.
+     *
+     * @param[in] name              The name of the call or the stage.
+     * @param[in] time              The time when the span ended.
+     */
+    virtual void end(std::string_view name, clock_t::time_point time) noexcept = 0;
+};
+
+/**
+ * @class chrome_trace_writer
+ *
+ * @brief The chrome_trace_writer class writes the spans to a file in the Chrome trace event
+ *        JSON format, which is opened by Perfetto UI and chrome://tracing.
+ *
+ * @note Each span is written as a pair of "B" and "E" events, timestamped in microseconds
+ *       since the construction of the writer, with the process and the thread ids of the caller.
+ *       The writer is thread-safe, the file is completed when the writer is destroyed.
+ */
+class chrome_trace_writer final : public span_tracer {
+public:
+
+    /**
+     * @brief Construct chrome_trace_writer, create the trace file.
+     *
+     * @param[in] trace_file        The path of the trace file, its previous contents are removed.
+     *
+     * @throws magic_trace_error    if the trace file can not be created.
+     */
+    explicit chrome_trace_writer(const std::filesystem::path& trace_file);
+
+    chrome_trace_writer(const chrome_trace_writer&) = delete;
+
+    chrome_trace_writer& operator=(const chrome_trace_writer&) = delete;
+
+    ~chrome_trace_writer() override;
+
+    void begin(std::string_view name, std::string_view detail, clock_t::time_point time) noexcept override;
+
+    void end(std::string_view name, clock_t::time_point time) noexcept override;
+
+    /**
+     * @brief Get the path of the trace file.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& file() const noexcept;
+
+    /**
+     * @brief Write the buffered events to the trace file.
+     */
+    void flush() noexcept;
+
+private:
+    std::filesystem::path m_trace_file;
+    clock_t::time_point m_start;
+    std::mutex m_mutex;
+    std::ofstream m_stream;
+    bool m_first_event{true};
+
+    void write_event(
+        std::string_view name, char phase,
+        std::string_view detail, clock_t::time_point time
+    ) noexcept;
+};
+
+} /* namespace recognition::trace */
+
+#endif /* MAGIC_SPAN_TRACER_HPP */
@@ -0,0 +1,288 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_STATISTICS_HPP
+#define MAGIC_STATISTICS_HPP
+
+#include <map>
+#include <span>
+#include <array>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+namespace recognition {
+
+/**
+ * @class latency_histogram
+ *
+ * @brief The latency_histogram class counts latencies in log-linear buckets, like an HDR histogram.
+ *
+ * @note Each power of two range of nanoseconds is divided into sub_bucket_count linear buckets,
+ *       so a recorded latency is reported with a relative error below 1 / sub_bucket_count.
+ *       The latencies longer than 2^max_value_bits nanoseconds are counted in the last bucket.
+ */
+class latency_histogram {
+public:
+    static constexpr std::size_t sub_bucket_bits  = 3;
+    static constexpr std::size_t sub_bucket_count = 1uz << sub_bucket_bits;
+    static constexpr std::size_t max_value_bits   = 40;
+    static constexpr std::size_t bucket_count     = (max_value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+    /**
+     * @brief The counts_t typedef.
+     */
+    using counts_t = std::array<std::uint64_t, bucket_count>;
+
+    /**
+     * @brief Construct an empty latency_histogram.
+     */
+    latency_histogram() noexcept = default;
+
+    /**
+     * @brief Construct latency_histogram from the counts of the buckets.
+     *
+     * @param[in] counts            The counts of the buckets.
+     * @param[in] total             The sum of the recorded latencies.
+     * @param[in] min               The minimum recorded latency.
+     * @param[in] max               The maximum recorded latency.
+     */
+    latency_histogram(
+        const counts_t& counts, std::chrono::nanoseconds total,
+        std::chrono::nanoseconds min, std::chrono::nanoseconds max
+    ) noexcept;
+
+    /**
+     * @brief Get the counts of the buckets.
+     */
+    [[nodiscard]]
+    std::span<const std::uint64_t, bucket_count> counts() const noexcept;
+
+    /**
+     * @brief Get the number of the recorded latencies.
+     */
+    [[nodiscard]]
+    std::uint64_t count() const noexcept;
+
+    /**
+     * @brief Get the maximum recorded latency, zero if the histogram is empty.
+     */
+    [[nodiscard]]
+    std::chrono::nanoseconds max() const noexcept;
+
+    /**
+     * @brief Get the mean of the recorded latencies, zero if the histogram is empty.
+     */
+    [[nodiscard]]
+    std::chrono::nanoseconds mean() const noexcept;
+
+    /**
+     * @brief Merge the recorded latencies of another histogram.
+     */
+    void merge(const latency_histogram& other) noexcept;
+
+    /**
+     * @brief Get the minimum recorded latency, zero if the histogram is empty.
+     */
+    [[nodiscard]]
+    std::chrono::nanoseconds min() const noexcept;
+
+    /**
+     * @brief Get a percentile of the recorded latencies.
+     *
+     * @param[in] percentile        The percentile in [0, 100].
+     *
+     * @returns The highest latency of the bucket of the percentile, zero if the histogram is empty.
+     */
+    [[nodiscard]]
+    std::chrono::nanoseconds percentile(double percentile) const noexcept;
+
+    /**
+     * @brief Record a latency.
+     */
+    void record(std::chrono::nanoseconds latency) noexcept;
+
+    /**
+     * @brief Get the sum of the recorded latencies.
+     */
+    [[nodiscard]]
+    std::chrono::nanoseconds total() const noexcept;
+
+    /**
+     * @brief Get the highest latency, in nanoseconds, counted in a bucket.
+     */
+    [[nodiscard]]
+    static std::uint64_t highest_value_of(std::size_t index) noexcept;
+
+    /**
+     * @brief Get the index of the bucket of a latency in nanoseconds.
+     */
+    [[nodiscard]]
+    static std::size_t index_of(std::uint64_t value) noexcept;
+
+    /**
+     * @brief Get the lowest latency, in nanoseconds, counted in a bucket.
+     */
+    [[nodiscard]]
+    static std::uint64_t lowest_value_of(std::size_t index) noexcept;
+
+private:
+    counts_t m_counts{};
+    std::uint64_t m_count{};
+    std::chrono::nanoseconds m_total{};
+    std::chrono::nanoseconds m_min{};
+    std::chrono::nanoseconds m_max{};
+};
+
+/**
+ * @brief The identification_stage enums are the stages of an identification timed by
+ *        magic::enable_stage_timing().
+ */
+enum class identification_stage : std::size_t {
+    traversal  = 0uz, /**< Advancing the directory iterator or the container of identify_files(). */
+    stat       = 1uz, /**< Getting the status of the file. */
+    open       = 2uz, /**< Opening the file. */
+    classify   = 3uz, /**< Reading the file and matching the database, including the decompression of the compressed files. */
+    conversion = 4uz  /**< Converting the result of libmagic into the type of the file. */
+};
+
+/**
+ * @brief The number of the identification_stage enums.
+ */
+inline constexpr auto identification_stage_count = 5uz;
+
+/**
+ * @brief The stage_durations_t typedef, indexed by the identification_stage enums.
+ */
+using stage_durations_t = std::array<std::chrono::nanoseconds, identification_stage_count>;
+
+/**
+ * @brief The identification_error enums are the types of the errors of the identifications,
+ *        named after the exceptions thrown by magic::identify_file().
+ */
+enum class identification_error : std::size_t {
+    magic_is_closed  = 0uz, /**< Magic is closed. */
+    empty_path       = 1uz, /**< The path of the file is empty. */
+    magic_file_error = 2uz  /**< libmagic failed to identify the file. */
+};
+
+/**
+ * @brief The number of the identification_error enums.
+ */
+inline constexpr auto identification_error_count = 3uz;
+
+/**
+ * @brief The type_cost struct is the cost of the identifications of the files of a type.
+ */
+struct type_cost {
+    std::uint64_t calls{};                  /**< The number of the identifications. */
+    std::uint64_t bytes{};                  /**< The total size of the regular files identified with the stage timing enabled. */
+    std::chrono::nanoseconds latency{};     /**< The sum of the latencies of the identifications. */
+    std::chrono::nanoseconds max_latency{}; /**< The maximum latency of the identifications. */
+};
+
+/**
+ * @brief The type_costs_t typedef, keyed by the types of the files.
+ */
+using type_costs_t = std::map<std::string, type_cost, std::less<>>;
+
+/**
+ * @brief The magic_statistics struct is a snapshot of the statistics of the identifications of a magic.
+ */
+struct magic_statistics {
+    std::uint64_t calls{};          /**< The number of the identify_file() calls, including the calls made by identify_files(). */
+    std::uint64_t errors{};         /**< The number of the failed calls. */
+    std::array<std::uint64_t, identification_error_count> errors_by_type{}; /**< The failed calls by identification_error. */
+    std::uint64_t bytes{};          /**< The total size of the regular files identified with the stage timing enabled. */
+    std::uint64_t cache_hits{};     /**< The number of the dispatch index sub databases found in the cache. */
+    std::uint64_t cache_misses{};   /**< The number of the dispatch index sub databases loaded. */
+    std::uint64_t database_loads{}; /**< The number of the database files and buffers loaded. */
+    std::uint64_t timed_calls{};    /**< The number of the calls timed by stage, see magic::enable_stage_timing(). */
+    stage_durations_t stage_durations{}; /**< The total durations of the stages of the timed calls. */
+    latency_histogram latency;      /**< The latencies of the calls. */
+    type_costs_t type_costs;        /**< The costs of the succeeded calls by type, see magic::enable_type_statistics(). */
+};
+
+/**
+ * @brief The magic_memory_usage struct is the memory held by a magic, in bytes.
+ *
+ * @note The heap allocated by libmagic is counted while libmagic opens the cookies and loads
+ *       their databases, the blocks allocated by libmagic later while it identifies the files,
+ *       such as its result buffer, are not counted.
+ *
+ * @note If libmagicxx is built with BUILD_MAGICXX_WITH_LIBMAGIC_HEAP_ACCOUNTING=ON, libmagic is
+ *       linked statically and its calls to the heap functions are counted, so the heap is the
+ *       exact sum of the requested sizes of its blocks. Otherwise, the heap is estimated from
+ *       the growth of the bytes in use of the process-wide glibc heap, which is unreliable if
+ *       other threads allocate or free concurrently, as their blocks are counted too, and zero
+ *       without glibc.
+ */
+struct magic_memory_usage {
+    std::size_t libmagic_heap{};     /**< The heap allocated by libmagic for the cookie and its loaded database. */
+    std::size_t mapped_database{};   /**< The compiled database file mapped by libmagic, shared with the page cache. */
+    std::size_t database_buffer{};   /**< The copy of the database loaded by load_database_buffer(). */
+    std::size_t dispatch_index{};    /**< The dispatch index and its copy of the compiled database. */
+    std::size_t indexed_databases{}; /**< The cached sub databases of the dispatch index, and their libmagic heap. */
+
+    /**
+     * @brief Get the sum of the memory usages.
+     */
+    [[nodiscard]]
+    std::size_t total() const noexcept
+    {
+        return libmagic_heap + mapped_database + database_buffer + dispatch_index +
+               indexed_databases;
+    }
+};
+
+/**
+ * @brief Convert the identification_stage to string.
+ *
+ * @param[in] stage             The stage.
+ *
+ * @returns The stage as a string.
+ */
+[[nodiscard]]
+std::string to_string(identification_stage stage);
+
+/**
+ * @brief Convert the identification_error to string.
+ *
+ * @param[in] error             The error.
+ *
+ * @returns The error as a string.
+ */
+[[nodiscard]]
+std::string to_string(identification_error error);
+
+/**
+ * @brief Render the statistics in the OpenMetrics text exposition format.
+ *
+ * @param[in] statistics        The statistics.
+ * @param[in] prefix            The prefix of the names of the metric families, default is "magicxx".
+ *
+ * @returns The counters of the calls, the errors by type, the identified bytes, the dispatch index
+ *          cache lookups, the database loads, the stage durations and the type costs, and the
+ *          latency histogram in seconds with a bucket per power of two nanoseconds, ending with "# EOF".
+ *
+ * @note The result is also accepted by the Prometheus text format parsers.
+ */
+[[nodiscard]]
+std::string to_openmetrics(const magic_statistics& statistics, std::string_view prefix = "magicxx");
+
+/**
+ * @brief Convert the type_costs_t to a report.
+ *
+ * @param[in] type_costs        The costs of the identifications by type.
+ *
+ * @returns A table of the types, sorted by their total latencies in descending order, holding
+ *          the share of the total latency, the calls, the bytes, the total, mean and maximum
+ *          latencies of each type.
+ */
+[[nodiscard]]
+std::string to_string(const type_costs_t& type_costs);
+
+} /* namespace recognition */
+
+#endif /* MAGIC_STATISTICS_HPP */
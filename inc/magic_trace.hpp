@@ -0,0 +1,145 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_TRACE_HPP
+#define MAGIC_TRACE_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+
+namespace recognition::trace {
+
+/**
+ * @brief The call enums are used for identifying the recorded calls of a magic.
+ */
+enum class call : std::uint8_t {
+    identify_file         = 0, /**< magic::identify_file(). */
+    identify_file_nothrow = 1, /**< magic::identify_file(), noexcept version. */
+    load_database_file    = 2, /**< magic::load_database_file(). */
+    load_database_buffer  = 3  /**< magic::load_database_buffer(). */
+};
+
+/**
+ * @brief The record struct describes a recorded call of a magic.
+ */
+struct record {
+    call kind;                          /**< The kind of the call. */
+    bool succeeded;                     /**< True if the call succeeded. */
+    std::uint64_t flags_mask;           /**< The flags of the magic at the time of the call. */
+    std::chrono::nanoseconds offset;    /**< The start of the call relative to the start of the recording. */
+    std::chrono::nanoseconds duration;  /**< The duration of the call. */
+    std::filesystem::path path;         /**< The path of the file, empty for load_database_buffer. */
+    std::uint64_t input_hash;           /**< The FNV-1a hash of the database buffer or of the captured prefix. */
+    std::string prefix;                 /**< The captured first bytes of the identified file. */
+};
+
+/**
+ * @class writer
+ *
+ * @brief The writer class writes the records of a magic to a compact binary trace file.
+ *
+ * @note The trace file starts with the "MAGICXXT" signature and the format version,
+ *       followed by the records whose integers and lengths are LEB128 encoded.
+ */
+class writer {
+public:
+
+    /**
+     * @brief The clock_t typedef, the clock of the offsets and the durations.
+     */
+    using clock_t = std::chrono::steady_clock;
+
+    /**
+     * @brief Construct writer, create the trace file.
+     *
+     * @param[in] trace_file        The path of the trace file, its previous contents are removed.
+     * @param[in] prefix_size       The number of the first bytes of the identified files captured.
+     *
+     * @throws magic_trace_error    if the trace file can not be created.
+     */
+    writer(const std::filesystem::path& trace_file, std::size_t prefix_size);
+
+    /**
+     * @brief Get the path of the trace file.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& file() const noexcept;
+
+    /**
+     * @brief Get the number of the first bytes of the identified files captured.
+     */
+    [[nodiscard]]
+    std::size_t prefix_size() const noexcept;
+
+    /**
+     * @brief Get the start of the recording.
+     */
+    [[nodiscard]]
+    clock_t::time_point start() const noexcept;
+
+    /**
+     * @brief Write a record to the trace file.
+     *
+     * @note The errors are ignored, so recording never changes the result of a call.
+     */
+    void write(const record& trace_record) noexcept;
+
+    /**
+     * @brief Write a record of a call on a file to the trace file, capturing
+     *        the first bytes of the file if the call identifies it.
+     */
+    void write_file_record(
+        call kind, bool succeeded, std::uint64_t flags_mask,
+        clock_t::time_point call_start, clock_t::time_point call_end,
+        const std::filesystem::path& path
+    ) noexcept;
+
+private:
+    std::filesystem::path m_file;
+    std::size_t m_prefix_size;
+    clock_t::time_point m_start;
+    std::ofstream m_stream;
+};
+
+/**
+ * @brief The signature of the trace files.
+ */
+inline constexpr std::string_view signature{"MAGICXXT"};
+
+/**
+ * @brief The format version of the trace files.
+ */
+inline constexpr std::uint8_t version{1};
+
+/**
+ * @brief Get the FNV-1a hash of bytes.
+ */
+[[nodiscard]]
+std::uint64_t hash(std::string_view bytes) noexcept;
+
+/**
+ * @brief Read the records of a trace file.
+ *
+ * @param[in] trace_file        The path of the trace file.
+ *
+ * @returns The records in the recorded order.
+ *
+ * @throws magic_trace_error    if the trace file can not be read or is malformed.
+ */
+[[nodiscard]]
+std::vector<record> read(const std::filesystem::path& trace_file);
+
+/**
+ * @brief Convert the trace::call to string.
+ */
+[[nodiscard]]
+std::string to_string(call kind);
+
+} /* namespace recognition::trace */
+
+#endif /* MAGIC_TRACE_HPP */
@@ -0,0 +1,168 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAGIC_TYPE_INDEX_HPP
+#define MAGIC_TYPE_INDEX_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+#include <magic_results.hpp>
+
+namespace recognition::results {
+
+/**
+ * @class type_index
+ *
+ * @brief The type_index class maps a type index file into memory, and finds the ids
+ *        of the paths of a type, which are the indexes of the records of a results file.
+ *
+ * @note The types are sorted and found by binary search, the ids of the paths of each type
+ *       are sorted and stored as LEB128 encoded deltas. Opening a type index file checks
+ *       its directory of types, a posting list is decoded only when its type is found.
+ */
+class type_index {
+public:
+
+    /**
+     * @brief Construct type_index, map the type index file into memory.
+     *
+     * @param[in] index_file        The path of the type index file.
+     *
+     * @throws magic_results_error  if the type index file can not be read or is malformed.
+     */
+    explicit type_index(const std::filesystem::path& index_file);
+
+    type_index(type_index&& other) noexcept;
+
+    type_index(const type_index&) = delete;
+
+    type_index& operator=(type_index&& other) noexcept;
+
+    type_index& operator=(const type_index&) = delete;
+
+    /**
+     * @brief Destruct type_index, unmap the type index file.
+     */
+    ~type_index();
+
+    /**
+     * @brief Get the number of the paths of a type, without decoding their ids.
+     */
+    [[nodiscard]]
+    std::size_t count(std::string_view type) const noexcept;
+
+    /**
+     * @brief Find the ids of the paths of a type.
+     *
+     * @returns The sorted ids of the paths, empty if there is no path of the type.
+     */
+    [[nodiscard]]
+    std::vector<std::uint64_t> find(std::string_view type) const;
+
+    /**
+     * @brief Get the sorted types.
+     */
+    [[nodiscard]]
+    std::vector<std::string_view> types() const;
+
+private:
+    const char* m_data{nullptr};
+    std::size_t m_size{};
+    std::size_t m_type_count{};
+    const char* m_directory{nullptr};
+    const char* m_types{nullptr};
+    const char* m_postings{nullptr};
+
+    void parse(const std::filesystem::path& index_file);
+
+    [[nodiscard]]
+    std::string_view get_type(std::size_t position) const noexcept;
+
+    [[nodiscard]]
+    std::optional<std::size_t> find_position(std::string_view type) const noexcept;
+};
+
+/**
+ * @class type_index_builder
+ *
+ * @brief The type_index_builder class builds the type index files, from scratch or by
+ *        updating a type index with the changes of the types of the paths.
+ */
+class type_index_builder {
+public:
+
+    /**
+     * @brief The change struct describes the change of the type of a path, such as
+     *        an added, a modified or a removed entry of a manifest diff.
+     */
+    struct change {
+        std::uint64_t path_id;              /**< The id of the path. */
+        std::optional<std::string> type;    /**< The new type, std::nullopt if the path is removed. */
+    };
+
+    /**
+     * @brief Construct an empty type_index_builder.
+     */
+    type_index_builder() = default;
+
+    /**
+     * @brief Construct type_index_builder from the types and the paths of a type index.
+     *
+     * @param[in] index             The type index to be updated.
+     */
+    explicit type_index_builder(const type_index& index);
+
+    /**
+     * @brief Add a path of a type.
+     *
+     * @param[in] path_id           The id of the path.
+     * @param[in] type              The type of the path.
+     */
+    void add(std::uint64_t path_id, std::string_view type);
+
+    /**
+     * @brief Add the records of a results file whose types are identified,
+     *        the ids of the paths are the indexes of the records.
+     *
+     * @param[in] results           The reader of the results file.
+     */
+    void add(const reader& results);
+
+    /**
+     * @brief Apply the changes, each path of the changes is removed from its previous type
+     *        and added to its new type.
+     *
+     * @param[in] changes           The changes of the types of the paths.
+     */
+    void apply(const std::vector<change>& changes);
+
+    /**
+     * @brief Write the type index file.
+     *
+     * @param[in] index_file        The path of the type index file, which is replaced atomically,
+     *                              so the type indexes mapping its previous contents are not affected.
+     *
+     * @throws magic_results_error  if writing the type index file fails.
+     */
+    void save(const std::filesystem::path& index_file);
+
+private:
+    std::map<std::string, std::vector<std::uint64_t>, std::less<>> m_path_ids;
+
+    void sort_path_ids();
+};
+
+/**
+ * @brief The signature of the type index files.
+ */
+inline constexpr std::string_view type_index_signature{"MAGICXXI"};
+
+} /* namespace recognition::results */
+
+#endif /* MAGIC_TYPE_INDEX_HPP */
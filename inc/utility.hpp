@@ -23,6 +23,8 @@ namespace utility {
  * @param[in] string_converter   The callable that converts values of the container to string.
  * 
  * @returns The container as a string.
+ *
+ * @note The values are appended to the string, the conversion is linear in the length of the string.
  */
 template <typename ContainerType, typename StringConverterType>
 requires std::ranges::range<ContainerType> && requires (ContainerType c){c.empty(); typename ContainerType::value_type;}
@@ -38,14 +40,12 @@ inline std::string to_string(
     if (container.empty()){
         return {};
     }
-    return std::ranges::fold_left(
-        std::ranges::next(std::ranges::begin(container)),
-        std::ranges::end(container),
-        std::invoke(string_converter, *std::ranges::begin(container)),
-        [&](const auto& left, const auto& right){
-            return left + value_separator + std::invoke(string_converter, right);
-        }
-    );
+    auto string = std::invoke(string_converter, *std::ranges::begin(container));
+    for (const auto& value : container | std::views::drop(1)){
+        string += value_separator;
+        string += std::invoke(string_converter, value);
+    }
+    return string;
 }
 
 } /* namespace utility */
@@ -10,6 +10,6 @@ which dnf &> /dev/null || {
 }
 
 echo "Installing the dependencies..."
-sudo dnf install -y cmake make ninja-build g++ clang libcxx-devel git autoconf libtool
+sudo dnf install -y cmake make ninja-build g++ clang libcxx-devel git autoconf libtool jq
 
 echo "Done"
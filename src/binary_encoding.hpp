@@ -0,0 +1,192 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef BINARY_ENCODING_HPP
+#define BINARY_ENCODING_HPP
+
+#include <bit>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <concepts>
+#include <stdexcept>
+#include <string_view>
+
+#include <magic_error.hpp>
+
+namespace recognition::binary {
+
+/**
+ * @brief Append a little endian fixed size integer to the buffer.
+ */
+template <std::unsigned_integral IntegerType>
+void write_integer(std::string& buffer, IntegerType value)
+{
+    if constexpr (std::endian::native == std::endian::big){
+        value = std::byteswap(value);
+    }
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Append little endian fixed size integers to the buffer.
+ */
+template <std::unsigned_integral IntegerType>
+void write_integers(std::string& buffer, const std::vector<IntegerType>& values)
+{
+    for (auto value : values){
+        write_integer(buffer, value);
+    }
+}
+
+/**
+ * @brief Read the little endian fixed size integer at index of the data.
+ */
+template <std::unsigned_integral IntegerType>
+[[nodiscard]]
+IntegerType read_integer(const char* data, std::size_t index = 0) noexcept
+{
+    IntegerType value;
+    std::memcpy(&value, data + index * sizeof(value), sizeof(value));
+    if constexpr (std::endian::native == std::endian::big){
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+/**
+ * @brief Append a LEB128 encoded integer to the buffer.
+ */
+inline void write_variable_integer(std::string& buffer, std::uint64_t value)
+{
+    do {
+        auto byte = static_cast<std::uint8_t>(value & 0x7F);
+        value >>= 7;
+        if (value != 0){
+            byte |= 0x80;
+        }
+        buffer.push_back(static_cast<char>(byte));
+    } while (value != 0);
+}
+
+/**
+ * @brief Read a LEB128 encoded integer byte by byte, next_byte() returns the next byte, or a
+ *        negative value at the end of the input.
+ *
+ * @returns The integer, or std::nullopt if the input ends inside it or it is longer than 64 bits.
+ */
+template <std::invocable NextByteFunction>
+[[nodiscard]]
+std::optional<std::uint64_t> read_variable_integer(NextByteFunction next_byte)
+{
+    std::uint64_t value{};
+    for (std::size_t shift{}; shift < 64; shift += 7){
+        const int byte = next_byte();
+        if (byte < 0){
+            return std::nullopt;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0){
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Read a LEB128 encoded integer, and advance the data past it, 0 if it is malformed.
+ */
+[[nodiscard]]
+inline std::uint64_t read_variable_integer(const char*& data, const char* end) noexcept
+{
+    return read_variable_integer(
+        [&]() noexcept {
+            return data != end ? static_cast<std::uint8_t>(*data++) : -1;
+        }
+    ).value_or(0);
+}
+
+/**
+ * @brief The offset basis of the 64-bit FNV-1a hash.
+ */
+inline constexpr std::uint64_t fnv_offset_basis = 0xcbf29ce484222325ULL;
+
+/**
+ * @brief The prime of the 64-bit FNV-1a hash.
+ */
+inline constexpr std::uint64_t fnv_prime = 0x100000001b3ULL;
+
+/**
+ * @brief Continue the 64-bit FNV-1a hash value over the bytes.
+ */
+[[nodiscard]]
+constexpr std::uint64_t hash(std::string_view bytes, std::uint64_t value = fnv_offset_basis) noexcept
+{
+    for (auto byte : bytes){
+        value = (value ^ static_cast<std::uint8_t>(byte)) * fnv_prime;
+    }
+    return value;
+}
+
+/**
+ * @brief Encode a magic_error, the code in the high and the errno in the low 16 bits,
+ *        0 if there is no error.
+ */
+[[nodiscard]]
+inline std::uint32_t encode_error(const magic_error& error) noexcept
+{
+    return (static_cast<std::uint32_t>(error.code()) << 16)
+         | (static_cast<std::uint32_t>(error.error_number()) & 0xFFFF);
+}
+
+/**
+ * @brief Decode a magic_error encoded by encode_error(), with its description.
+ */
+[[nodiscard]]
+inline magic_error decode_error(std::uint32_t error, std::string_view description = {}) noexcept
+{
+    return magic_error{static_cast<magic_errc>(error >> 16), static_cast<int>(error & 0xFFFF), description};
+}
+
+/**
+ * @brief The cursor class reads the fixed size integers of a mapped file, checking their bounds.
+ *
+ * @note std::out_of_range is thrown if the file is truncated.
+ */
+class cursor {
+public:
+    cursor(const char* data, std::size_t size, std::size_t position) noexcept
+        : m_data{data},
+          m_size{size},
+          m_position{position}
+    { }
+
+    [[nodiscard]]
+    const char* skip(std::uint64_t size)
+    {
+        if (m_position > m_size || size > m_size - m_position){
+            throw std::out_of_range{"truncated"};
+        }
+        auto data = m_data + m_position;
+        m_position += size;
+        return data;
+    }
+
+    template <std::unsigned_integral IntegerType>
+    [[nodiscard]]
+    IntegerType read()
+    {
+        return read_integer<IntegerType>(skip(sizeof(IntegerType)));
+    }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+    std::size_t m_position;
+};
+
+} /* namespace recognition::binary */
+
+#endif /* BINARY_ENCODING_HPP */
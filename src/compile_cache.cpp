@@ -0,0 +1,135 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <random>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include "compile_cache.hpp"
+#include "binary_encoding.hpp"
+
+namespace recognition {
+
+compile_cache::compile_cache(std::filesystem::path cache_directory)
+    : m_directory{std::move(cache_directory)}
+{ }
+
+const std::filesystem::path& compile_cache::directory() const noexcept
+{
+    return m_directory;
+}
+
+std::filesystem::path compile_cache::get(
+    const std::filesystem::path& database_file,
+    std::string_view version,
+    const compile_t& compile) const noexcept
+{
+    try {
+        auto cache_key = key(database_file, version);
+        if (!cache_key){
+            return {};
+        }
+        std::error_code error;
+        auto compiled_file = m_directory / (*cache_key + ".mgc");
+        if (std::filesystem::is_regular_file(compiled_file, error)){
+            return compiled_file;
+        }
+        std::filesystem::create_directories(m_directory, error);
+        auto source = std::filesystem::absolute(database_file, error);
+        if (error){
+            return {};
+        }
+        const auto name = std::format("{}-{}", *cache_key, std::random_device{}());
+        const auto link = m_directory / name;
+        if (std::filesystem::is_directory(source, error)){
+            std::filesystem::create_directory_symlink(source, link, error);
+        } else {
+            std::filesystem::create_symlink(source, link, error);
+        }
+        if (error){
+            return {};
+        }
+        const bool compiled = compile(link);
+        std::filesystem::remove(link, error);
+        const auto temporary_file = std::filesystem::current_path() / (name + ".mgc");
+        const auto cached_temporary_file = m_directory / (name + ".mgc");
+        if (compiled){
+            std::filesystem::rename(temporary_file, cached_temporary_file, error);
+        }
+        if (!compiled || error){
+            if (compiled){
+                std::filesystem::copy_file(temporary_file, cached_temporary_file, error);
+            }
+            std::filesystem::remove(temporary_file, error);
+        }
+        if (!compiled || !std::filesystem::is_regular_file(cached_temporary_file, error)){
+            return {};
+        }
+        std::filesystem::rename(cached_temporary_file, compiled_file, error);
+        if (error){
+            std::filesystem::remove(cached_temporary_file, error);
+            return {};
+        }
+        return compiled_file;
+    } catch (...){
+        return {};
+    }
+}
+
+std::optional<std::string> compile_cache::key(const std::filesystem::path& database_file, std::string_view version) noexcept
+{
+    try {
+        auto value = binary::fnv_offset_basis;
+        hash(value, version);
+        if (!std::filesystem::is_directory(database_file)){
+            if (!hash_file(value, database_file)){
+                return std::nullopt;
+            }
+            return std::format("{:016x}", value);
+        }
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator{database_file}){
+            if (entry.is_regular_file()){
+                files.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(files);
+        for (const auto& file : files){
+            hash(value, file.filename().string());
+            if (!hash_file(value, file)){
+                return std::nullopt;
+            }
+        }
+        return std::format("{:016x}", value);
+    } catch (...){
+        return std::nullopt;
+    }
+}
+
+void compile_cache::hash(std::uint64_t& value, std::string_view bytes)
+{
+    std::string size;
+    binary::write_integer<std::uint64_t>(size, bytes.size());
+    value = binary::hash(bytes, binary::hash(size, value));
+}
+
+bool compile_cache::hash_file(std::uint64_t& value, const std::filesystem::path& file)
+{
+    std::ifstream stream{file, std::ios::binary};
+    if (!stream){
+        return false;
+    }
+    std::string contents{
+        std::istreambuf_iterator<char>{stream},
+        std::istreambuf_iterator<char>{}
+    };
+    if (stream.bad()){
+        return false;
+    }
+    hash(value, contents);
+    return true;
+}
+
+} /* namespace recognition */
@@ -0,0 +1,83 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef COMPILE_CACHE_HPP
+#define COMPILE_CACHE_HPP
+
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+namespace recognition {
+
+/**
+ * @class compile_cache
+ *
+ * @brief The compile_cache class keeps the compiled (.mgc) forms of the magic database
+ *        files in a cache directory, named by the hash of their contents.
+ *
+ * @note The key of a database file is the FNV-1a hash of the version of the Magic Number
+ *       Recognition Library and the contents of the file, or the names and the contents
+ *       of the files of the directory, so a changed database file is compiled again.
+ */
+class compile_cache {
+public:
+
+    /**
+     * @brief The compile_t typedef, compiles the database file into the current working directory.
+     */
+    using compile_t = std::function<bool(const std::filesystem::path&)>;
+
+    /**
+     * @brief Construct compile_cache over a cache directory, which is created when needed.
+     */
+    explicit compile_cache(std::filesystem::path cache_directory);
+
+    /**
+     * @brief Get the cache directory.
+     */
+    [[nodiscard]]
+    const std::filesystem::path& directory() const noexcept;
+
+    /**
+     * @brief Get the cached compiled form of a database file, compile it if it is not cached.
+     *
+     * @param[in] database_file     The path of the database file or directory.
+     * @param[in] version           The version of the Magic Number Recognition Library.
+     * @param[in] compile           Compiles a database file into the current working directory.
+     *
+     * @returns The path of the cached compiled database file, or an empty path on failure.
+     *
+     * @note The database file is compiled through a symbolic link named by its key, so the compiled
+     *       file is created in the current working directory temporarily and moved to the cache.
+     */
+    [[nodiscard]]
+    std::filesystem::path get(
+        const std::filesystem::path& database_file,
+        std::string_view version,
+        const compile_t& compile
+    ) const noexcept;
+
+    /**
+     * @brief Get the key of a database file.
+     *
+     * @returns The key as a hexadecimal string, or std::nullopt if database_file can not be read.
+     */
+    [[nodiscard]]
+    static std::optional<std::string> key(const std::filesystem::path& database_file, std::string_view version) noexcept;
+
+private:
+    std::filesystem::path m_directory;
+
+    static void hash(std::uint64_t& value, std::string_view bytes);
+
+    [[nodiscard]]
+    static bool hash_file(std::uint64_t& value, const std::filesystem::path& file);
+};
+
+} /* namespace recognition */
+
+#endif /* COMPILE_CACHE_HPP */
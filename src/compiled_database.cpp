@@ -0,0 +1,181 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include "compiled_database.hpp"
+
+namespace recognition {
+
+std::uint64_t compiled_database::entry_t::num_mask() const noexcept
+{
+    std::uint64_t mask{};
+    std::memcpy(&mask, &str_range, sizeof(mask));
+    return mask;
+}
+
+std::uint64_t compiled_database::entry_t::num_value() const noexcept
+{
+    std::uint64_t value{};
+    std::memcpy(&value, this->value.data(), sizeof(value));
+    return value;
+}
+
+std::optional<compiled_database> compiled_database::read(const std::filesystem::path& database_file) noexcept
+{
+    try {
+        std::ifstream file{database_file, std::ios::binary};
+        if (!file){
+            return std::nullopt;
+        }
+        return read(std::vector<char>{
+            std::istreambuf_iterator<char>{file},
+            std::istreambuf_iterator<char>{}
+        });
+    } catch (...){
+        return std::nullopt;
+    }
+}
+
+std::optional<compiled_database> compiled_database::read(std::vector<char> database) noexcept
+{
+    try {
+        compiled_database compiled{std::move(database)};
+        if (!compiled.parse()){
+            return std::nullopt;
+        }
+        return compiled;
+    } catch (...){
+        return std::nullopt;
+    }
+}
+
+std::filesystem::path compiled_database::find(const std::filesystem::path& database_file)
+{
+    std::error_code error;
+    if (database_file.extension() == ".mgc"){
+        return std::filesystem::is_regular_file(database_file, error) ? database_file : std::filesystem::path{};
+    }
+    auto compiled_database_file = database_file;
+    compiled_database_file += ".mgc";
+    return std::filesystem::is_regular_file(compiled_database_file, error) ? compiled_database_file : std::filesystem::path{};
+}
+
+compiled_database::entry_t compiled_database::entry(std::size_t index) const noexcept
+{
+    entry_t entry;
+    std::memcpy(&entry, m_data.data() + (index + 1) * entry_size, entry_size);
+    return entry;
+}
+
+bool compiled_database::needs_full_database(const entry_t& entry) const
+{
+    if (entry.type == type_indirect){
+        return true;
+    }
+    if (entry.type != type_use){
+        return false;
+    }
+    auto named_block = m_named_blocks.find(used_name(entry));
+    return named_block == m_named_blocks.end() || m_blocks[named_block->second].needs_full_database;
+}
+
+const std::vector<compiled_database::block_t>& compiled_database::blocks() const noexcept
+{
+    return m_blocks;
+}
+
+std::size_t compiled_database::memory_usage() const noexcept
+{
+    auto usage = sizeof(*this) + m_data.capacity() + m_blocks.capacity() * sizeof(block_t);
+    for (const auto& [name, index] : m_named_blocks){
+        usage += 4 * sizeof(void*) + sizeof(name) + name.capacity() + sizeof(index);
+    }
+    return usage;
+}
+
+std::vector<char> compiled_database::extract(const std::vector<bool>& included_blocks) const
+{
+    std::array<std::uint32_t, set_count> set_sizes{};
+    std::size_t entry_count{};
+    for (std::size_t i{}; i < m_blocks.size(); ++i){
+        if (included_blocks[i]){
+            set_sizes[m_blocks[i].set] += m_blocks[i].count;
+            entry_count += m_blocks[i].count;
+        }
+    }
+    std::vector<char> database((entry_count + 1) * entry_size);
+    std::memcpy(database.data(), m_data.data(), entry_size);
+    std::memcpy(database.data() + 2 * sizeof(std::uint32_t), set_sizes.data(), sizeof(set_sizes));
+    auto output = database.data() + entry_size;
+    for (std::size_t i{}; i < m_blocks.size(); ++i){
+        if (included_blocks[i]){
+            const auto& block = m_blocks[i];
+            output = std::copy_n(
+                m_data.data() + (block.first + 1) * entry_size,
+                block.count * entry_size,
+                output
+            );
+        }
+    }
+    return database;
+}
+
+compiled_database::compiled_database(std::vector<char>&& data)
+    : m_data{std::move(data)}
+{ }
+
+bool compiled_database::parse()
+{
+    if (m_data.size() < entry_size || m_data.size() % entry_size != 0){
+        return false;
+    }
+    std::array<std::uint32_t, 2 + set_count> header{};
+    std::memcpy(header.data(), m_data.data(), sizeof(header));
+    if (header[0] != magic_no || header[1] != version_no){
+        return false;
+    }
+    const auto entry_count = m_data.size() / entry_size - 1;
+    if (static_cast<std::size_t>(header[2]) + header[3] != entry_count){
+        return false;
+    }
+    for (std::size_t i{}; i < entry_count; ++i){
+        auto current = entry(i);
+        const std::size_t set = i < header[2] ? 0 : 1;
+        if (current.cont_level == 0 || m_blocks.empty() || m_blocks.back().set != set){
+            m_blocks.push_back({i, 0, set});
+            if (current.type == type_name){
+                m_named_blocks.emplace(used_name(current), m_blocks.size() - 1);
+            }
+        }
+        auto& block = m_blocks.back();
+        ++block.count;
+        block.needs_full_database = block.needs_full_database || current.type == type_indirect;
+    }
+    for (bool changed = true; changed; ){
+        changed = false;
+        for (auto& block : m_blocks){
+            for (std::size_t i{}; i < block.count && !block.needs_full_database; ++i){
+                block.needs_full_database = needs_full_database(entry(block.first + i));
+                changed = changed || block.needs_full_database;
+            }
+        }
+    }
+    return true;
+}
+
+std::string_view compiled_database::used_name(const entry_t& entry) noexcept
+{
+    std::string_view name{
+        reinterpret_cast<const char*>(entry.value.data()),
+        static_cast<std::size_t>(std::ranges::find(entry.value, '\0') - entry.value.begin())
+    };
+    if (entry.type == type_use && name.starts_with('^')){
+        name.remove_prefix(1);
+    }
+    return name;
+}
+
+} /* namespace recognition */
@@ -0,0 +1,204 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef COMPILED_DATABASE_HPP
+#define COMPILED_DATABASE_HPP
+
+#include <map>
+#include <span>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+namespace recognition {
+
+/**
+ * @class compiled_database
+ *
+ * @brief The compiled_database class provides a read only view over a compiled (.mgc)
+ *        magic database file and extracts compiled sub databases from it.
+ *
+ * @note Only the compiled database format of the bundled Magic Number Recognition Library
+ *       in the native byte order is supported.
+ */
+class compiled_database {
+public:
+
+    /**
+     * @brief The entry_t struct mirrors the struct magic of the Magic Number Recognition Library.
+     */
+    struct entry_t {
+        std::uint16_t cont_level;
+        std::uint8_t  flag;
+        std::uint8_t  factor;
+        std::uint8_t  reln;
+        std::uint8_t  vallen;
+        std::uint8_t  type;
+        std::uint8_t  in_type;
+        std::uint8_t  in_op;
+        std::uint8_t  mask_op;
+        std::uint8_t  cond;
+        std::uint8_t  factor_op;
+        std::int32_t  offset;
+        std::int32_t  in_offset;
+        std::uint32_t lineno;
+        std::uint32_t str_range;
+        std::uint32_t str_flags;
+        std::array<unsigned char, 128uz> value;
+        std::array<char, 64uz> desc;
+        std::array<char, 80uz> mimetype;
+        std::array<char, 8uz>  apple;
+        std::array<char, 64uz> ext;
+
+        /**
+         * @brief The mask of the numeric types, shares its storage with str_range and str_flags.
+         */
+        [[nodiscard]]
+        std::uint64_t num_mask() const noexcept;
+
+        /**
+         * @brief The value of the numeric types.
+         */
+        [[nodiscard]]
+        std::uint64_t num_value() const noexcept;
+    };
+
+    /**
+     * @brief The block_t struct describes a top level entry with its continuation entries.
+     */
+    struct block_t {
+        std::size_t first;               /**< The index of the top level entry. */
+        std::size_t count;               /**< The number of entries in the block. */
+        std::size_t set;                 /**< The magic set of the block, 0 for the tests and 1 for the named blocks. */
+        bool needs_full_database{false}; /**< True if the block reaches an indirect entry, which reevaluates the whole database. */
+    };
+
+    /**
+     * @brief The types, flags and operators of the entries used by the wrapper.
+     */
+    enum entry_type : std::uint8_t {
+        type_byte     = 1,
+        type_short    = 2,
+        type_default  = 3,
+        type_long     = 4,
+        type_string   = 5,
+        type_beshort  = 7,
+        type_belong   = 8,
+        type_leshort  = 10,
+        type_lelong   = 11,
+        type_search   = 20,
+        type_quad     = 24,
+        type_lequad   = 25,
+        type_bequad   = 26,
+        type_indirect = 41,
+        type_name     = 45,
+        type_use      = 46
+    };
+
+    static constexpr std::uint8_t flag_indir        = 0x01;
+    static constexpr std::uint8_t flag_offadd       = 0x02;
+    static constexpr std::uint8_t flag_indiroffadd  = 0x04;
+    static constexpr std::uint8_t flag_unsigned     = 0x08;
+    static constexpr std::uint8_t flag_bintest      = 0x20;
+    static constexpr std::uint8_t flag_texttest     = 0x40;
+    static constexpr std::uint8_t flag_offnegative  = 0x80;
+    static constexpr std::uint8_t flag_offset_mask  = flag_indir | flag_offadd | flag_indiroffadd | flag_offnegative;
+    static constexpr std::uint32_t str_flags_loose  = 0x0f;
+    static constexpr std::uint8_t mask_op_and       = 0;
+
+    static constexpr std::size_t entry_size    = 376uz;
+    static constexpr std::size_t set_count     = 2uz;
+    static constexpr std::uint32_t magic_no    = 0xF11E041C;
+    static constexpr std::uint32_t version_no  = 18;
+
+    /**
+     * @brief Read a compiled database file.
+     *
+     * @param[in] database_file     The path of the compiled database file.
+     *
+     * @returns The compiled database, or std::nullopt if database_file is not
+     *          a compiled database file supported by the wrapper.
+     */
+    [[nodiscard]]
+    static std::optional<compiled_database> read(const std::filesystem::path& database_file) noexcept;
+
+    /**
+     * @brief Read a compiled database from memory.
+     *
+     * @param[in] database          The contents of the compiled database file.
+     *
+     * @returns The compiled database, or std::nullopt if database is not
+     *          a compiled database supported by the wrapper.
+     */
+    [[nodiscard]]
+    static std::optional<compiled_database> read(std::vector<char> database) noexcept;
+
+    /**
+     * @brief Find the compiled database file which the Magic Number Recognition Library
+     *        loads for database_file, the file itself or the file with “.mgc” appended.
+     *
+     * @param[in] database_file     The path of the database file.
+     *
+     * @returns The path of the compiled database file, or an empty path if it does not exist.
+     */
+    [[nodiscard]]
+    static std::filesystem::path find(const std::filesystem::path& database_file);
+
+    /**
+     * @brief Get the entry at index.
+     */
+    [[nodiscard]]
+    entry_t entry(std::size_t index) const noexcept;
+
+    /**
+     * @brief Used for testing whether evaluating the entry reevaluates the whole database,
+     *        which is true for indirect entries and the entries using such named blocks.
+     */
+    [[nodiscard]]
+    bool needs_full_database(const entry_t& entry) const;
+
+    /**
+     * @brief Get the blocks in the order of the database.
+     */
+    [[nodiscard]]
+    const std::vector<block_t>& blocks() const noexcept;
+
+    /**
+     * @brief Get the approximate number of bytes held by the compiled database.
+     */
+    [[nodiscard]]
+    std::size_t memory_usage() const noexcept;
+
+    /**
+     * @brief Extract a compiled sub database.
+     *
+     * @param[in] included_blocks   included_blocks[i] is true if blocks()[i] is part of the sub database.
+     *
+     * @returns The compiled sub database, which preserves the order of the included blocks.
+     */
+    [[nodiscard]]
+    std::vector<char> extract(const std::vector<bool>& included_blocks) const;
+
+private:
+    std::vector<char> m_data;
+    std::vector<block_t> m_blocks;
+    std::map<std::string, std::size_t, std::less<>> m_named_blocks;
+
+    explicit compiled_database(std::vector<char>&& data);
+
+    [[nodiscard]]
+    bool parse();
+
+    [[nodiscard]]
+    static std::string_view used_name(const entry_t& entry) noexcept;
+};
+
+static_assert(sizeof(compiled_database::entry_t) == compiled_database::entry_size);
+
+} /* namespace recognition */
+
+#endif /* COMPILED_DATABASE_HPP */
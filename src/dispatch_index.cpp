@@ -0,0 +1,246 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <bit>
+#include <map>
+#include <limits>
+#include <algorithm>
+
+#include "dispatch_index.hpp"
+
+namespace recognition {
+
+namespace {
+
+/**
+ * @brief Get the width and the byte order of the fixed width numeric types.
+ */
+[[nodiscard]]
+std::optional<std::pair<std::size_t, std::endian>> numeric_layout(std::uint8_t type) noexcept
+{
+    switch (type){
+    case compiled_database::type_byte:    return std::pair{1uz, std::endian::native};
+    case compiled_database::type_short:   return std::pair{2uz, std::endian::native};
+    case compiled_database::type_beshort: return std::pair{2uz, std::endian::big};
+    case compiled_database::type_leshort: return std::pair{2uz, std::endian::little};
+    case compiled_database::type_long:    return std::pair{4uz, std::endian::native};
+    case compiled_database::type_belong:  return std::pair{4uz, std::endian::big};
+    case compiled_database::type_lelong:  return std::pair{4uz, std::endian::little};
+    case compiled_database::type_quad:    return std::pair{8uz, std::endian::native};
+    case compiled_database::type_bequad:  return std::pair{8uz, std::endian::big};
+    case compiled_database::type_lequad:  return std::pair{8uz, std::endian::little};
+    default:                              return std::nullopt;
+    }
+}
+
+[[nodiscard]]
+std::uint64_t truncate(std::uint64_t value, std::size_t width) noexcept
+{
+    return width == 8 ? value : value & ((1ULL << (width * 8)) - 1);
+}
+
+[[nodiscard]]
+std::uint64_t sign_extend(std::uint64_t value, std::size_t width) noexcept
+{
+    const auto shift = 64 - width * 8;
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(value << shift) >> shift);
+}
+
+} /* namespace */
+
+dispatch_index::dispatch_index(compiled_database database)
+    : m_database{std::move(database)}
+{
+    std::map<std::pair<std::size_t, std::size_t>, std::size_t> slot_ids;
+    const auto& blocks = m_database.blocks();
+    m_block_groups.resize(blocks.size(), always_included);
+    for (std::size_t i{}; i < blocks.size(); ++i){
+        const auto& block = blocks[i];
+        auto entry = m_database.entry(block.first);
+        if (block.needs_full_database && entry.type != compiled_database::type_name){
+            m_guarded_blocks.push_back(i);
+            m_needs_full_database = m_needs_full_database || block.set != 0;
+        }
+        auto bytes = block.set == 0 && !is_text_test(entry) ? constant_bytes(entry) : std::nullopt;
+        if (!bytes){
+            continue;
+        }
+        const std::size_t offset = entry.offset;
+        auto [slot_id, new_slot] = slot_ids.try_emplace({offset, bytes->size()}, m_slots.size());
+        if (new_slot){
+            m_slots.push_back({offset, bytes->size(), {}});
+        }
+        auto [group, new_group] = m_slots[slot_id->second].groups.try_emplace(std::move(*bytes), m_group_count);
+        if (new_group){
+            ++m_group_count;
+        }
+        m_block_groups[i] = group->second;
+    }
+}
+
+std::optional<dispatch_index::key_t> dispatch_index::select(std::span<const unsigned char> prefix) const
+{
+    if (m_needs_full_database){
+        return std::nullopt;
+    }
+    key_t key;
+    for (const auto& slot : m_slots){
+        std::string_view bytes{
+            reinterpret_cast<const char*>(prefix.data()) + slot.offset, slot.length
+        };
+        auto group = slot.groups.find(bytes);
+        if (group != slot.groups.end()){
+            key.push_back(group->second);
+        }
+    }
+    std::ranges::sort(key);
+    for (auto i : m_guarded_blocks){
+        const auto group = m_block_groups[i];
+        if ((group == always_included || std::ranges::binary_search(key, group)) &&
+            may_need_full_database(m_database.blocks()[i], prefix)){
+            return std::nullopt;
+        }
+    }
+    return key;
+}
+
+std::size_t dispatch_index::memory_usage() const noexcept
+{
+    auto usage = m_database.memory_usage() + sizeof(*this) - sizeof(m_database) +
+                 m_block_groups.capacity() * sizeof(std::uint32_t) +
+                 m_guarded_blocks.capacity() * sizeof(std::size_t) +
+                 m_slots.capacity() * sizeof(slot_t);
+    for (const auto& slot : m_slots){
+        usage += slot.groups.bucket_count() * sizeof(void*);
+        for (const auto& [bytes, group] : slot.groups){
+            usage += 2 * sizeof(void*) + sizeof(bytes) + bytes.capacity() + sizeof(group);
+        }
+    }
+    return usage;
+}
+
+std::vector<char> dispatch_index::extract(const key_t& key) const
+{
+    std::vector<bool> included_blocks(m_block_groups.size());
+    for (std::size_t i{}; i < m_block_groups.size(); ++i){
+        included_blocks[i] = m_block_groups[i] == always_included ||
+                             std::ranges::binary_search(key, m_block_groups[i]);
+    }
+    return m_database.extract(included_blocks);
+}
+
+std::optional<std::string> dispatch_index::constant_bytes(const compiled_database::entry_t& entry)
+{
+    if (entry.reln != '=' || entry.offset < 0 || entry.cond != 0 ||
+        (entry.flag & compiled_database::flag_offset_mask) != 0){
+        return std::nullopt;
+    }
+    std::string bytes;
+    if (entry.type == compiled_database::type_string){
+        if (entry.vallen == 0 || (entry.str_flags & compiled_database::str_flags_loose) != 0){
+            return std::nullopt;
+        }
+        bytes.assign(reinterpret_cast<const char*>(entry.value.data()), entry.vallen);
+    } else if (auto layout = numeric_layout(entry.type)){
+        if (entry.mask_op != compiled_database::mask_op_and || entry.num_mask() != 0){
+            return std::nullopt;
+        }
+        auto [width, order] = *layout;
+        auto value = entry.num_value();
+        for (std::size_t i{}; i < width; ++i){
+            const auto shift = order == std::endian::big ? (width - 1 - i) * 8 : i * 8;
+            bytes.push_back(static_cast<char>((value >> shift) & 0xff));
+        }
+    } else {
+        return std::nullopt;
+    }
+    if (static_cast<std::size_t>(entry.offset) + bytes.size() > prefix_size){
+        return std::nullopt;
+    }
+    return bytes;
+}
+
+bool dispatch_index::may_need_full_database(
+    const compiled_database::block_t& block, std::span<const unsigned char> prefix) const
+{
+    const bool text_test = is_text_test(m_database.entry(block.first));
+    std::vector<bool> may_match_level;
+    for (std::size_t i{}; i < block.count; ++i){
+        auto entry = m_database.entry(block.first + i);
+        const std::size_t level = entry.cont_level;
+        if (level > may_match_level.size()){
+            return true;
+        }
+        may_match_level.resize(level + 1);
+        may_match_level[level] = (level == 0 || may_match_level[level - 1]) &&
+                                 (text_test || may_match(entry, prefix));
+        if (may_match_level[level] && m_database.needs_full_database(entry)){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool dispatch_index::is_text_test(const compiled_database::entry_t& entry) noexcept
+{
+    return (entry.flag & compiled_database::flag_texttest) != 0;
+}
+
+bool dispatch_index::may_match(const compiled_database::entry_t& entry, std::span<const unsigned char> prefix)
+{
+    if (entry.offset < 0 || entry.cond != 0 ||
+        (entry.flag & compiled_database::flag_offset_mask) != 0){
+        return true;
+    }
+    const std::size_t offset = entry.offset;
+    if (entry.type == compiled_database::type_string){
+        if (entry.reln != '=' || entry.vallen == 0 ||
+            (entry.str_flags & compiled_database::str_flags_loose) != 0 ||
+            offset + entry.vallen > prefix.size()){
+            return true;
+        }
+        return std::ranges::equal(prefix.subspan(offset, entry.vallen), std::span{entry.value}.first(entry.vallen));
+    }
+    if (entry.type == compiled_database::type_search){
+        if (entry.reln != '=' || entry.vallen == 0 ||
+            (entry.str_flags & compiled_database::str_flags_loose) != 0 ||
+            offset + entry.str_range + entry.vallen > prefix.size()){
+            return true;
+        }
+        auto window = prefix.subspan(offset, entry.str_range + entry.vallen);
+        auto needle = std::span{entry.value}.first(entry.vallen);
+        return !std::ranges::search(window, needle).empty();
+    }
+    auto layout = numeric_layout(entry.type);
+    if (!layout || entry.mask_op != compiled_database::mask_op_and){
+        return true;
+    }
+    auto [width, order] = *layout;
+    if (offset + width > prefix.size()){
+        return true;
+    }
+    std::uint64_t value{};
+    for (std::size_t i{}; i < width; ++i){
+        const auto shift = order == std::endian::big ? (width - 1 - i) * 8 : i * 8;
+        value |= static_cast<std::uint64_t>(prefix[offset + i]) << shift;
+    }
+    if (entry.num_mask() != 0){
+        value &= truncate(entry.num_mask(), width);
+    }
+    const bool is_unsigned = (entry.flag & compiled_database::flag_unsigned) != 0;
+    if (!is_unsigned){
+        value = sign_extend(value, width);
+    }
+    const auto expected = entry.num_value();
+    switch (entry.reln){
+    case '=': return truncate(value, width) == truncate(expected, width);
+    case '!': return value != expected;
+    case '<': return is_unsigned ? value < expected :
+                     static_cast<std::int64_t>(value) < static_cast<std::int64_t>(expected);
+    case '>': return is_unsigned ? value > expected :
+                     static_cast<std::int64_t>(value) > static_cast<std::int64_t>(expected);
+    default:  return true;
+    }
+}
+
+} /* namespace recognition */
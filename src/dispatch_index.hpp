@@ -0,0 +1,109 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef DISPATCH_INDEX_HPP
+#define DISPATCH_INDEX_HPP
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "compiled_database.hpp"
+
+namespace recognition {
+
+/**
+ * @class dispatch_index
+ *
+ * @brief The dispatch_index class groups the top level binary entries of a compiled database
+ *        by the constant bytes they test at fixed offsets, and selects the candidate sub database
+ *        of a file by its first bytes.
+ *
+ * @note A candidate sub database contains every block that can match the file in the same order
+ *       as the full database, so identifying the file with it gives the same result as the full scan.
+ *       The text tests are evaluated on the text converted to UTF-8, so they are always included.
+ */
+class dispatch_index {
+public:
+
+    /**
+     * @brief The key_t typedef, the sorted ids of the groups matched by the first bytes of a file.
+     */
+    using key_t = std::vector<std::uint32_t>;
+
+    /**
+     * @brief The number of first bytes of a file used for selecting a sub database.
+     */
+    static constexpr std::size_t prefix_size = 4096uz;
+
+    /**
+     * @brief Construct dispatch_index over a compiled database.
+     */
+    explicit dispatch_index(compiled_database database);
+
+    /**
+     * @brief Select the candidate sub database of a file.
+     *
+     * @param[in] prefix    The first prefix_size bytes of the file, the bytes past
+     *                      the end of the file must be zero.
+     *
+     * @returns The key of the candidate sub database, or std::nullopt if the file
+     *          must be identified using the full database.
+     */
+    [[nodiscard]]
+    std::optional<key_t> select(std::span<const unsigned char> prefix) const;
+
+    /**
+     * @brief Extract the candidate sub database of a key returned by select().
+     */
+    [[nodiscard]]
+    std::vector<char> extract(const key_t& key) const;
+
+    /**
+     * @brief Get the approximate number of bytes held by the index and its compiled database.
+     */
+    [[nodiscard]]
+    std::size_t memory_usage() const noexcept;
+
+private:
+    struct transparent_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view bytes) const noexcept
+        {
+            return std::hash<std::string_view>{}(bytes);
+        }
+    };
+
+    struct slot_t {
+        std::size_t offset;
+        std::size_t length;
+        std::unordered_map<std::string, std::uint32_t, transparent_hash, std::equal_to<>> groups;
+    };
+
+    static constexpr auto always_included = std::numeric_limits<std::uint32_t>::max();
+
+    compiled_database m_database;
+    std::vector<std::uint32_t> m_block_groups;
+    std::vector<std::size_t> m_guarded_blocks;
+    std::vector<slot_t> m_slots;
+    std::uint32_t m_group_count{};
+    bool m_needs_full_database{false};
+
+    [[nodiscard]]
+    static std::optional<std::string> constant_bytes(const compiled_database::entry_t& entry);
+
+    [[nodiscard]]
+    bool may_need_full_database(const compiled_database::block_t& block, std::span<const unsigned char> prefix) const;
+
+    [[nodiscard]]
+    static bool is_text_test(const compiled_database::entry_t& entry) noexcept;
+
+    [[nodiscard]]
+    static bool may_match(const compiled_database::entry_t& entry, std::span<const unsigned char> prefix);
+};
+
+} /* namespace recognition */
+
+#endif /* DISPATCH_INDEX_HPP */
@@ -0,0 +1,265 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <cstdio>
+#include <limits>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <sys/types.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "heap_counter.hpp"
+
+namespace recognition {
+
+namespace {
+
+#ifdef MAGICXX_COUNT_LIBMAGIC_HEAP
+
+/**
+ * @brief The bytes requested by the blocks allocated minus the blocks freed by libmagic on this thread.
+ */
+thread_local std::ptrdiff_t libmagic_heap_in_use{};
+
+/**
+ * @brief The size of the header before each block of libmagic, which holds the requested size
+ *        of the block, so the count does not depend on the reuse of the free chunks.
+ */
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+[[nodiscard]]
+void* allocate(std::size_t size) noexcept
+{
+    if (size > std::numeric_limits<std::size_t>::max() - header_size){
+        errno = ENOMEM;
+        return nullptr;
+    }
+    auto header = static_cast<char*>(std::malloc(header_size + size));
+    if (!header){
+        return nullptr;
+    }
+    std::memcpy(header, &size, sizeof(size));
+    libmagic_heap_in_use += static_cast<std::ptrdiff_t>(size);
+    return header + header_size;
+}
+
+[[nodiscard]]
+void* reallocate(void* block, std::size_t size) noexcept
+{
+    if (!block){
+        return allocate(size);
+    }
+    if (size > std::numeric_limits<std::size_t>::max() - header_size){
+        errno = ENOMEM;
+        return nullptr;
+    }
+    std::size_t previous_size;
+    std::memcpy(&previous_size, static_cast<char*>(block) - header_size, sizeof(previous_size));
+    auto header = static_cast<char*>(std::realloc(static_cast<char*>(block) - header_size, header_size + size));
+    if (!header){
+        return nullptr;
+    }
+    std::memcpy(header, &size, sizeof(size));
+    libmagic_heap_in_use += static_cast<std::ptrdiff_t>(size) - static_cast<std::ptrdiff_t>(previous_size);
+    return header + header_size;
+}
+
+void deallocate(void* block) noexcept
+{
+    if (!block){
+        return;
+    }
+    std::size_t size;
+    std::memcpy(&size, static_cast<char*>(block) - header_size, sizeof(size));
+    libmagic_heap_in_use -= static_cast<std::ptrdiff_t>(size);
+    std::free(static_cast<char*>(block) - header_size);
+}
+
+/**
+ * @brief Returns the bytes in use of the heap allocated by libmagic on this thread,
+ *        which is negative if it freed the blocks allocated on other threads.
+ */
+[[nodiscard]]
+std::ptrdiff_t get_heap_in_use() noexcept
+{
+    return libmagic_heap_in_use;
+}
+
+#else
+
+/**
+ * @brief Returns the bytes in use of the process-wide glibc heap, zero without glibc.
+ */
+[[nodiscard]]
+std::ptrdiff_t get_heap_in_use() noexcept
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const auto heap_info = ::mallinfo2();
+    return static_cast<std::ptrdiff_t>(heap_info.uordblks + heap_info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+#endif
+
+} /* namespace */
+
+heap_counter::heap_counter() noexcept
+    : m_heap_in_use{get_heap_in_use()}
+{ }
+
+[[nodiscard]]
+std::ptrdiff_t heap_counter::allocated() const noexcept
+{
+    return get_heap_in_use() - m_heap_in_use;
+}
+
+} /* namespace recognition */
+
+#ifdef MAGICXX_COUNT_LIBMAGIC_HEAP
+
+/**
+ * @brief The heap functions called by libmagic, whose calls are redirected to them
+ *        by renaming the symbols of its static library, see CMakeLists.txt.
+ */
+extern "C" {
+
+using recognition::allocate;
+using recognition::reallocate;
+using recognition::deallocate;
+
+void* magicxx_libmagic_malloc(std::size_t size)
+{
+    return allocate(size);
+}
+
+void* magicxx_libmagic_calloc(std::size_t count, std::size_t size)
+{
+    if (size != 0 && count > std::numeric_limits<std::size_t>::max() / size){
+        errno = ENOMEM;
+        return nullptr;
+    }
+    auto block = allocate(count * size);
+    if (block){
+        std::memset(block, 0, count * size);
+    }
+    return block;
+}
+
+void* magicxx_libmagic_realloc(void* block, std::size_t size)
+{
+    return reallocate(block, size);
+}
+
+void magicxx_libmagic_free(void* block)
+{
+    deallocate(block);
+}
+
+char* magicxx_libmagic_strndup(const char* string, std::size_t size)
+{
+    const auto length = ::strnlen(string, size);
+    auto copy = static_cast<char*>(allocate(length + 1));
+    if (copy){
+        std::memcpy(copy, string, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+char* magicxx_libmagic_strdup(const char* string)
+{
+    return magicxx_libmagic_strndup(string, std::numeric_limits<std::size_t>::max());
+}
+
+int magicxx_libmagic_vasprintf(char** string, const char* format, std::va_list arguments)
+{
+    std::va_list length_arguments;
+    va_copy(length_arguments, arguments);
+    const auto length = std::vsnprintf(nullptr, 0, format, length_arguments);
+    va_end(length_arguments);
+    if (length < 0){
+        return -1;
+    }
+    auto formatted = static_cast<char*>(allocate(static_cast<std::size_t>(length) + 1));
+    if (!formatted){
+        return -1;
+    }
+    std::vsnprintf(formatted, static_cast<std::size_t>(length) + 1, format, arguments);
+    *string = formatted;
+    return length;
+}
+
+int magicxx_libmagic_asprintf(char** string, const char* format, ...)
+{
+    std::va_list arguments;
+    va_start(arguments, format);
+    const auto result = magicxx_libmagic_vasprintf(string, format, arguments);
+    va_end(arguments);
+    return result;
+}
+
+int magicxx_libmagic___vasprintf_chk(char** string, int, const char* format, std::va_list arguments)
+{
+    return magicxx_libmagic_vasprintf(string, format, arguments);
+}
+
+int magicxx_libmagic___asprintf_chk(char** string, int, const char* format, ...)
+{
+    std::va_list arguments;
+    va_start(arguments, format);
+    const auto result = magicxx_libmagic_vasprintf(string, format, arguments);
+    va_end(arguments);
+    return result;
+}
+
+::ssize_t magicxx_libmagic_getdelim(char** line, std::size_t* size, int delimiter, std::FILE* stream)
+{
+    if (!line || !size){
+        errno = EINVAL;
+        return -1;
+    }
+    std::size_t length{};
+    for (int character; (character = std::getc(stream)) != EOF; ){
+        if (!*line || length + 2 > *size){
+            const auto new_size = std::max(2 * length + 2, 128uz);
+            auto new_line = static_cast<char*>(reallocate(*line, new_size));
+            if (!new_line){
+                return -1;
+            }
+            *line = new_line;
+            *size = new_size;
+        }
+        (*line)[length++] = static_cast<char>(character);
+        if (character == delimiter){
+            break;
+        }
+    }
+    if (length == 0){
+        return -1;
+    }
+    (*line)[length] = '\0';
+    return static_cast<::ssize_t>(length);
+}
+
+::ssize_t magicxx_libmagic___getdelim(char** line, std::size_t* size, int delimiter, std::FILE* stream)
+{
+    return magicxx_libmagic_getdelim(line, size, delimiter, stream);
+}
+
+::ssize_t magicxx_libmagic_getline(char** line, std::size_t* size, std::FILE* stream)
+{
+    return magicxx_libmagic_getdelim(line, size, '\n', stream);
+}
+
+} /* extern "C" */
+
+#endif
@@ -0,0 +1,58 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef HEAP_COUNTER_HPP
+#define HEAP_COUNTER_HPP
+
+#include <cstddef>
+
+namespace recognition {
+
+/**
+ * @class heap_counter
+ *
+ * @brief The heap_counter class counts the heap allocated by libmagic while it is alive.
+ *
+ * @note If MAGICXX_COUNT_LIBMAGIC_HEAP is defined, by the BUILD_MAGICXX_WITH_LIBMAGIC_HEAP_ACCOUNTING
+ *       CMake option, libmagic is linked statically with its heap functions renamed to the counting
+ *       functions of heap_counter.cpp, and the count is the requested size of the blocks allocated
+ *       minus the blocks freed by libmagic on the calling thread, which is exact.
+ *
+ * @note Otherwise, the count is an estimate, the growth of the bytes in use of the whole glibc
+ *       heap, which is process-wide, so it includes the blocks allocated and freed meanwhile
+ *       by the other threads, and it is zero without glibc.
+ */
+class heap_counter {
+public:
+
+    /**
+     * @brief Construct heap_counter, start counting.
+     */
+    heap_counter() noexcept;
+
+    heap_counter(const heap_counter&) = delete;
+
+    heap_counter& operator=(const heap_counter&) = delete;
+
+    /**
+     * @brief Get the bytes allocated minus the bytes freed since the counter is constructed.
+     */
+    [[nodiscard]]
+    std::ptrdiff_t allocated() const noexcept;
+
+    /**
+     * @brief Add the growth of a heap to its size, the size never goes below zero.
+     */
+    [[nodiscard]]
+    static std::size_t add_to(std::size_t heap, std::ptrdiff_t growth) noexcept
+    {
+        return growth < 0 && static_cast<std::size_t>(-growth) > heap ? 0 : heap + static_cast<std::size_t>(growth);
+    }
+
+private:
+    std::ptrdiff_t m_heap_in_use;
+};
+
+} /* namespace recognition */
+
+#endif /* HEAP_COUNTER_HPP */
@@ -0,0 +1,93 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <array>
+
+#include "json_string.hpp"
+
+namespace recognition::json {
+
+namespace {
+
+constexpr std::array<char, 16> hex_digits{
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+/**
+ * @brief Appends the escape sequence of a UTF-16 code unit.
+ */
+void append_escape(std::string& buffer, unsigned code_unit)
+{
+    buffer += "\\u";
+    buffer += hex_digits[(code_unit >> 12) & 0xf];
+    buffer += hex_digits[(code_unit >> 8) & 0xf];
+    buffer += hex_digits[(code_unit >> 4) & 0xf];
+    buffer += hex_digits[code_unit & 0xf];
+}
+
+/**
+ * @brief Gets the length of the valid UTF-8 sequence at the start of the string,
+ *        0 if the string does not start with one.
+ */
+std::size_t get_utf8_sequence_length(std::string_view string) noexcept
+{
+    const auto byte = [&](std::size_t index){
+        return static_cast<unsigned char>(string[index]);
+    };
+    const auto is_continuation = [&](std::size_t index){
+        return index < string.size() && (byte(index) & 0xc0) == 0x80;
+    };
+    const auto lead = byte(0);
+    if (lead >= 0xc2 && lead <= 0xdf){
+        return is_continuation(1) ? 2 : 0;
+    }
+    if (lead >= 0xe0 && lead <= 0xef){
+        if (string.size() < 3 || !is_continuation(1) || !is_continuation(2)){
+            return 0;
+        }
+        if ((lead == 0xe0 && byte(1) < 0xa0) || (lead == 0xed && byte(1) > 0x9f)){
+            return 0;
+        }
+        return 3;
+    }
+    if (lead >= 0xf0 && lead <= 0xf4){
+        if (string.size() < 4 || !is_continuation(1) || !is_continuation(2) || !is_continuation(3)){
+            return 0;
+        }
+        if ((lead == 0xf0 && byte(1) < 0x90) || (lead == 0xf4 && byte(1) > 0x8f)){
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+
+} /* namespace */
+
+void append_string(std::string& buffer, std::string_view string)
+{
+    while (!string.empty()){
+        const auto byte = static_cast<unsigned char>(string.front());
+        std::size_t length{1};
+        switch (byte){
+        case '"':  buffer += "\\\""; break;
+        case '\\': buffer += "\\\\"; break;
+        case '\n': buffer += "\\n";  break;
+        case '\t': buffer += "\\t";  break;
+        default:
+            if (byte < 0x20){
+                append_escape(buffer, byte);
+            } else if (byte < 0x80){
+                buffer += static_cast<char>(byte);
+            } else if ((length = get_utf8_sequence_length(string)) != 0){
+                buffer.append(string.substr(0, length));
+            } else {
+                length = 1;
+                append_escape(buffer, 0xdc00 | byte);
+            }
+        }
+        string.remove_prefix(length);
+    }
+}
+
+} /* namespace recognition::json */
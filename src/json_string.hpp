@@ -0,0 +1,27 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef JSON_STRING_HPP
+#define JSON_STRING_HPP
+
+#include <string>
+#include <string_view>
+
+namespace recognition::json {
+
+/**
+ * @brief Append a string to a JSON string literal, without the quotes.
+ *
+ * @param[in,out] buffer        The buffer.
+ * @param[in] string            The string, its bytes are not required to be valid UTF-8.
+ *
+ * @note The quotes, the backslashes and the control characters are escaped. The bytes that
+ *       are not part of a valid UTF-8 sequence are escaped as the lone surrogates U+DC80 to
+ *       U+DCFF, like the surrogateescape error handler of Python, so the bytes of any path
+ *       are written losslessly.
+ */
+void append_string(std::string& buffer, std::string_view string);
+
+} /* namespace recognition::json */
+
+#endif /* JSON_STRING_HPP */
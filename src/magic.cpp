@@ -3,10 +3,24 @@
 
 #include <cmath>
 #include <array>
+#include <cerrno>
+#include <chrono>
+#include <limits>
 #include <format>
+#include <ranges>
+#include <fcntl.h>
 #include <utility>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include <magic.hpp>
+#include <magic_trace.hpp>
+#include <magic_sorted_collector.hpp>
+
+#include "compile_cache.hpp"
+#include "heap_counter.hpp"
+#include "dispatch_index.hpp"
+#include "statistics_recorder.hpp"
 
 namespace recognition {
 
@@ -14,6 +28,16 @@ namespace detail {
 #include <magic.h>
 } /* namespace detail */
 
+/**
+ * @brief The statistics of the identifications are not recorded if MAGICXX_DISABLE_STATISTICS
+ *        is defined, by the BUILD_MAGICXX_WITH_STATISTICS=OFF CMake option.
+ */
+#ifdef MAGICXX_DISABLE_STATISTICS
+inline constexpr bool statistics_enabled{false};
+#else
+inline constexpr bool statistics_enabled{true};
+#endif
+
 class magic::magic_private {
 public:
     magic_private() noexcept = default;
@@ -52,6 +76,11 @@ public:
     void close() noexcept
     {
         m_cookie.reset(nullptr);
+        m_cookie_heap = 0;
+        m_database_heap = 0;
+        m_database_file.clear();
+        m_database_buffer.clear();
+        build_dispatch_index();
     }
 
     bool compile(const std::filesystem::path& database_file) const noexcept
@@ -59,10 +88,41 @@ public:
         if (!is_open() || database_file.empty()){
             return false;
         }
+        if (m_compile_cache){
+            return compile_using_compile_cache(database_file);
+        }
         auto result = detail::magic_compile(m_cookie.get(), database_file.c_str());
         return result != libmagic_error;
     }
 
+    void enable_dispatch_index(bool enable) noexcept
+    {
+        m_dispatch_index_enabled = enable;
+        build_dispatch_index();
+    }
+
+    void enable_stage_timing(bool enable) noexcept
+    {
+        m_stage_timing_enabled = enable;
+        m_traversal_duration = {};
+    }
+
+    void enable_statistics(bool enable) noexcept
+    {
+        m_statistics_enabled = enable;
+    }
+
+    void enable_type_statistics(bool enable) noexcept
+    {
+        m_type_statistics_enabled = enable;
+    }
+
+    [[nodiscard]]
+    std::filesystem::path get_compile_cache_directory() const
+    {
+        return m_compile_cache ? m_compile_cache->directory() : std::filesystem::path{};
+    }
+
     [[nodiscard]]
     flags_container_t get_flags() const
     {
@@ -70,6 +130,29 @@ public:
         return flags_converter(m_flags_mask);
     }
 
+    [[nodiscard]]
+    magic_memory_usage get_memory_usage() const noexcept
+    {
+        magic_memory_usage memory_usage{
+            .libmagic_heap = m_cookie_heap + m_database_heap,
+            .database_buffer = m_database_buffer.capacity(),
+            .dispatch_index = m_dispatch_index ? m_dispatch_index->memory_usage() : 0
+        };
+        try {
+            if (!m_database_file.empty()){
+                std::error_code error;
+                const auto mapped_database_size = std::filesystem::file_size(compiled_database::find(m_database_file), error);
+                memory_usage.mapped_database = error ? 0 : mapped_database_size;
+            }
+        } catch (...){
+        }
+        for (const auto& [key, indexed_database] : m_indexed_databases){
+            memory_usage.indexed_databases += key.capacity() * sizeof(key.front()) +
+                indexed_database.database.capacity() + indexed_database.libmagic_heap;
+        }
+        return memory_usage;
+    }
+
     [[nodiscard]]
     std::size_t get_parameter(parameters parameter) const
     {
@@ -96,31 +179,63 @@ public:
         return parameter_value_map;
     }
 
+    [[nodiscard]]
+    std::shared_ptr<trace::span_tracer> get_span_tracer() const noexcept
+    {
+        return m_span_tracer;
+    }
+
+    [[nodiscard]]
+    stage_durations_t get_stage_durations() const noexcept
+    {
+        return m_stage_durations;
+    }
+
+    [[nodiscard]]
+    magic_statistics get_statistics() const noexcept
+    {
+        return m_statistics.snapshot();
+    }
+
     [[nodiscard]]
     file_type_t identify_file(const std::filesystem::path& path) const
     {
-        throw_exception_on_failure<magic_is_closed>(is_open());
-        throw_exception_on_failure<empty_path>(!path.empty());
-        auto type_cstr = detail::magic_file(m_cookie.get(), path.c_str());
-        throw_exception_on_failure<magic_file_error>(type_cstr != nullptr, path);
-        return type_cstr;
+        if (!is_observed()){
+            return identify_file_unobserved(path);
+        }
+        const auto start = clock_t::now();
+        begin_span(trace::call::identify_file, path.native(), start);
+        try {
+            auto file_type = identify_file_unobserved(path);
+            observe_identification(trace::call::identify_file, true, start, path, file_type);
+            return file_type;
+        } catch (...){
+            observe_identification(trace::call::identify_file, false, start, path);
+            throw;
+        }
     }
 
     [[nodiscard]]
     expected_file_type_t
         identify_file(const std::filesystem::path& path, std::nothrow_t) const noexcept
     {
-        if (!is_open()){
-            return std::unexpected{magic_is_closed{}.what()};
+        if (!is_observed()){
+            return identify_file_unobserved(path, std::nothrow);
         }
-        if (path.empty()){
-            return std::unexpected{empty_path{}.what()};
-        }
-        auto type_cstr = detail::magic_file(m_cookie.get(), path.c_str());
-        if (!type_cstr){
-            return std::unexpected{magic_file_error{get_error_message(), path}.what()};
-        }
-        return {type_cstr};
+        const auto start = clock_t::now();
+        begin_span(trace::call::identify_file_nothrow, path.native(), start);
+        auto expected_file_type = identify_file_unobserved(path, std::nothrow);
+        observe_identification(
+            trace::call::identify_file_nothrow, expected_file_type.has_value(),
+            start, path, expected_file_type ? std::string_view{*expected_file_type} : std::string_view{}
+        );
+        return expected_file_type;
+    }
+
+    [[nodiscard]]
+    bool is_dispatch_index_enabled() const noexcept
+    {
+        return m_dispatch_index_enabled;
     }
 
     [[nodiscard]]
@@ -129,20 +244,72 @@ public:
         return m_cookie != nullptr;
     }
 
+    [[nodiscard]]
+    bool is_recording() const noexcept
+    {
+        return m_trace_writer != nullptr;
+    }
+
+    [[nodiscard]]
+    bool is_stage_timing_enabled() const noexcept
+    {
+        return m_stage_timing_enabled;
+    }
+
+    [[nodiscard]]
+    bool is_statistics_enabled() const noexcept
+    {
+        return statistics_enabled && m_statistics_enabled;
+    }
+
+    [[nodiscard]]
+    bool is_type_statistics_enabled() const noexcept
+    {
+        return m_type_statistics_enabled;
+    }
+
+    void load_database_buffer(std::span<const char> database_buffer)
+    {
+        if (!is_traced()){
+            return load_database_buffer_untraced(database_buffer);
+        }
+        const auto start = clock_t::now();
+        begin_span(trace::call::load_database_buffer, {}, start);
+        try {
+            load_database_buffer_untraced(database_buffer);
+            write_trace_record(true, start, database_buffer);
+        } catch (...){
+            write_trace_record(false, start, database_buffer);
+            throw;
+        }
+    }
+
     void load_database_file(const std::filesystem::path& database_file)
     {
-        throw_exception_on_failure<magic_is_closed>(is_open());
-        throw_exception_on_failure<empty_path>(!database_file.empty());
-        throw_exception_on_failure<invalid_path>(std::filesystem::is_regular_file(database_file));
-        throw_exception_on_failure<magic_load_error>(
-            detail::magic_load(m_cookie.get(), database_file.c_str()),
-            database_file.c_str()
-        );
+        if (!is_traced()){
+            return load_database_file_untraced(database_file);
+        }
+        const auto start = clock_t::now();
+        begin_span(trace::call::load_database_file, database_file.native(), start);
+        try {
+            load_database_file_untraced(database_file);
+            write_trace_record(trace::call::load_database_file, true, start, database_file);
+        } catch (...){
+            write_trace_record(trace::call::load_database_file, false, start, database_file);
+            throw;
+        }
     }
 
     void open(flags_mask_t flags_mask)
     {
+        m_cookie.reset(nullptr);
+        heap_counter libmagic_heap_counter;
         m_cookie.reset(detail::magic_open(flags_converter(flags_mask)));
+        m_cookie_heap = heap_counter::add_to(0, libmagic_heap_counter.allocated());
+        m_database_heap = 0;
+        m_database_file.clear();
+        m_database_buffer.clear();
+        build_dispatch_index();
         throw_exception_on_failure<magic_open_error>(is_open());
         m_flags_mask = flags_mask;
     }
@@ -152,6 +319,30 @@ public:
         open(flags_mask_t{flags_converter(flags_container)});
     }
 
+    void record_traversal(std::chrono::nanoseconds duration) const noexcept
+    {
+        m_traversal_duration += duration;
+        if (m_span_tracer){
+            const auto end = clock_t::now();
+            m_span_tracer->begin(to_string(identification_stage::traversal), {}, end - duration);
+            m_span_tracer->end(to_string(identification_stage::traversal), end);
+        }
+    }
+
+    void reset_statistics() noexcept
+    {
+        m_statistics.reset();
+    }
+
+    void set_compile_cache_directory(const std::filesystem::path& cache_directory)
+    {
+        if (cache_directory.empty()){
+            m_compile_cache.reset();
+        } else {
+            m_compile_cache.emplace(cache_directory);
+        }
+    }
+
     void set_flags(flags_mask_t flags_mask)
     {
         throw_exception_on_failure<magic_is_closed>(is_open());
@@ -160,6 +351,7 @@ public:
             flags_converter(flags_mask)
         );
         m_flags_mask = flags_mask;
+        m_indexed_databases.clear();
     }
 
     void set_flags(const flags_container_t& flags_container)
@@ -181,6 +373,7 @@ public:
             ),
             libmagic_pair_converter(libmagic_parameter), value
         );
+        m_indexed_databases.clear();
     }
 
     void set_parameters(const parameter_value_map_t& parameters)
@@ -194,15 +387,60 @@ public:
         );
     }
 
+    void set_span_tracer(std::shared_ptr<trace::span_tracer> span_tracer) noexcept
+    {
+        m_span_tracer = std::move(span_tracer);
+    }
+
+    void start_recording(const std::filesystem::path& trace_file, std::size_t prefix_size)
+    {
+        throw_exception_on_failure<empty_path>(!trace_file.empty());
+        m_trace_writer = std::make_unique<trace::writer>(trace_file, prefix_size);
+    }
+
+    void stop_recording() noexcept
+    {
+        m_trace_writer.reset();
+    }
+
 private:
+    using clock_t = std::chrono::steady_clock;
+
     using cookie_t = std::unique_ptr<detail::magic_set, decltype(
         [](detail::magic_t cookie) noexcept {
             detail::magic_close(cookie);
         }
     )>;
 
+    struct indexed_database_t {
+        std::vector<char> database;
+        cookie_t cookie;
+        std::size_t last_use;
+        std::size_t libmagic_heap{};
+    };
+
     cookie_t m_cookie{nullptr};
     flags_mask_t m_flags_mask{0};
+    std::filesystem::path m_database_file;
+    std::vector<char> m_database_buffer;
+    std::size_t m_cookie_heap{};
+    std::size_t m_database_heap{};
+    std::optional<compile_cache> m_compile_cache;
+    bool m_dispatch_index_enabled{false};
+    std::unique_ptr<dispatch_index> m_dispatch_index;
+    mutable std::map<dispatch_index::key_t, indexed_database_t> m_indexed_databases;
+    mutable std::size_t m_dispatch_count{};
+    std::unique_ptr<trace::writer> m_trace_writer;
+    std::shared_ptr<trace::span_tracer> m_span_tracer;
+    mutable statistics_recorder m_statistics;
+    bool m_stage_timing_enabled{false};
+    bool m_statistics_enabled{false};
+    bool m_type_statistics_enabled{false};
+    mutable std::uintmax_t m_identified_bytes{};
+    mutable stage_durations_t m_stage_durations{};
+    mutable std::chrono::nanoseconds m_traversal_duration{};
+
+    static constexpr auto max_indexed_databases = 16uz;
 
     static constexpr auto libmagic_error           = -1;
     static constexpr auto libmagic_flags_count     = flags_mask_t{}.size();
@@ -286,6 +524,476 @@ private:
         }
     }
 
+    /**
+     * @brief Returns the cached compiled form of a database file if the compile cache is used
+     *        and the Magic Number Recognition Library would parse the database file,
+     *        returns the database file otherwise.
+     */
+    [[nodiscard]]
+    std::filesystem::path get_cached_database_file(const std::filesystem::path& database_file) const
+    {
+        if (!m_compile_cache || !compiled_database::find(database_file).empty()){
+            return database_file;
+        }
+        auto cached_database_file = compile_into_compile_cache(database_file);
+        return cached_database_file.empty() ? database_file : cached_database_file;
+    }
+
+    /**
+     * @brief Returns the cached compiled form of a database file, compiles it into
+     *        the compile cache if it is not cached, returns an empty path on failure.
+     */
+    [[nodiscard]]
+    std::filesystem::path compile_into_compile_cache(const std::filesystem::path& database_file) const noexcept
+    {
+        return m_compile_cache->get(database_file, magic::get_version(),
+            [this](const std::filesystem::path& source){
+                return detail::magic_compile(m_cookie.get(), source.c_str()) != libmagic_error;
+            }
+        );
+    }
+
+    /**
+     * @brief Compiles the colon separated list of database files by copying
+     *        their cached compiled forms into the current working directory.
+     */
+    [[nodiscard]]
+    bool compile_using_compile_cache(const std::filesystem::path& database_file) const noexcept
+    {
+        try {
+            for (auto part : std::views::split(database_file.native(), ':')){
+                std::filesystem::path source{std::string_view{part}};
+                auto cached_database_file = compile_into_compile_cache(source);
+                auto compiled_file = source.filename();
+                if (compiled_file.extension() != ".mgc"){
+                    compiled_file += ".mgc";
+                }
+                std::error_code error;
+                if (cached_database_file.empty() || !std::filesystem::copy_file(
+                        cached_database_file, compiled_file,
+                        std::filesystem::copy_options::overwrite_existing, error)){
+                    return false;
+                }
+            }
+            return true;
+        } catch (...){
+            return false;
+        }
+    }
+
+    /**
+     * @brief Rebuilds the dispatch index over the loaded database file if it is enabled.
+     */
+    void build_dispatch_index() noexcept
+    {
+        m_indexed_databases.clear();
+        m_dispatch_index.reset();
+        if (!m_dispatch_index_enabled || !is_open() ||
+            (m_database_file.empty() && m_database_buffer.empty())){
+            return;
+        }
+        try {
+            auto database = m_database_buffer.empty() ?
+                compiled_database::read(compiled_database::find(m_database_file)) :
+                compiled_database::read(m_database_buffer);
+            if (database){
+                m_dispatch_index = std::make_unique<dispatch_index>(std::move(*database));
+            }
+        } catch (...){
+            m_dispatch_index.reset();
+        }
+    }
+
+    [[nodiscard]]
+    file_type_t identify_file_unobserved(const std::filesystem::path& path) const
+    {
+        throw_exception_on_failure<magic_is_closed>(is_open());
+        throw_exception_on_failure<empty_path>(!path.empty());
+        auto file_type = identify_file_type(path);
+        throw_exception_on_failure<magic_file_error>(file_type.has_value(), path);
+        return std::move(*file_type);
+    }
+
+    [[nodiscard]]
+    expected_file_type_t
+        identify_file_unobserved(const std::filesystem::path& path, std::nothrow_t) const noexcept
+    {
+        if (!is_open()){
+            return std::unexpected{magic_error{magic_errc::magic_is_closed}};
+        }
+        if (path.empty()){
+            return std::unexpected{magic_error{magic_errc::empty_path}};
+        }
+        auto file_type = identify_file_type(path);
+        if (!file_type){
+            const char* description = detail::magic_error(m_cookie.get());
+            return std::unexpected{magic_error{
+                magic_errc::magic_file_error, detail::magic_errno(m_cookie.get()), description ? description : ""
+            }};
+        }
+        return std::move(*file_type);
+    }
+
+    /**
+     * @brief Identifies the type of a file, returns std::nullopt if libmagic fails.
+     */
+    [[nodiscard]]
+    std::optional<file_type_t> identify_file_type(const std::filesystem::path& path) const
+    {
+        m_identified_bytes = 0;
+        if (m_stage_timing_enabled){
+            return identify_file_type_by_stage(path);
+        }
+        const char* type_cstr{nullptr};
+        struct ::stat status{};
+        if (is_dispatched() && get_file_status(path, status) && is_identified_by_descriptor(status)){
+            const int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            type_cstr = descriptor != -1 ? identify_descriptor(descriptor) : detail::magic_file(m_cookie.get(), path.c_str());
+            if (descriptor != -1){
+                ::close(descriptor);
+            }
+        } else {
+            type_cstr = detail::magic_file(m_cookie.get(), path.c_str());
+        }
+        if (!type_cstr){
+            return std::nullopt;
+        }
+        return type_cstr;
+    }
+
+    /**
+     * @brief Identifies the type of a file like identify_file_type(), timing its stages.
+     *
+     * @note The regular files are identified by their descriptors, except the files which libmagic
+     *       describes by their status or their path. The bytes of the file are read by libmagic
+     *       itself, so the classify stage holds the I/O of the file, and the file is read once.
+     *       Closing the file is not timed.
+     */
+    [[nodiscard]]
+    std::optional<file_type_t> identify_file_type_by_stage(const std::filesystem::path& path) const
+    {
+        using enum identification_stage;
+        stage_durations_t stage_durations{};
+        stage_durations[std::to_underlying(traversal)] = std::exchange(m_traversal_duration, {});
+        auto stage_start = clock_t::now();
+        auto end_stage = [&](identification_stage stage){
+            const auto stage_end = clock_t::now();
+            stage_durations[std::to_underlying(stage)] += stage_end - stage_start;
+            if (m_span_tracer){
+                m_span_tracer->begin(to_string(stage), {}, stage_start);
+                m_span_tracer->end(to_string(stage), stage_end);
+            }
+            stage_start = stage_end;
+        };
+        struct ::stat status{};
+        const bool is_regular_file = get_file_status(path, status) && S_ISREG(status.st_mode);
+        const auto file_size = is_regular_file ? static_cast<std::uintmax_t>(status.st_size) : 0;
+        end_stage(stat);
+        int descriptor{-1};
+        if (is_regular_file && is_identified_by_descriptor(status)){
+            descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            end_stage(open);
+        }
+        std::optional<file_type_t> file_type;
+        auto type_cstr = descriptor != -1 ? identify_descriptor(descriptor)
+                                          : detail::magic_file(m_cookie.get(), path.c_str());
+        end_stage(classify);
+        if (type_cstr){
+            file_type.emplace(type_cstr);
+            end_stage(conversion);
+        }
+        if (descriptor != -1){
+            ::close(descriptor);
+        }
+        m_stage_durations = stage_durations;
+        m_identified_bytes = file_type ? file_size : 0;
+        if (is_statistics_enabled()){
+            m_statistics.record_stages(stage_durations);
+        }
+        return file_type;
+    }
+
+    void load_database_buffer_untraced(std::span<const char> database_buffer)
+    {
+        throw_exception_on_failure<magic_is_closed>(is_open());
+        std::vector<char> database{database_buffer.begin(), database_buffer.end()};
+        void* buffers[]{database.data()};
+        std::size_t sizes[]{database.size()};
+        heap_counter libmagic_heap_counter;
+        const auto result = detail::magic_load_buffers(m_cookie.get(), buffers, sizes, 1);
+        m_database_heap = heap_counter::add_to(m_database_heap, libmagic_heap_counter.allocated());
+        throw_exception_on_failure<magic_load_error>(result, "buffer");
+        m_database_buffer = std::move(database);
+        m_database_file.clear();
+        build_dispatch_index();
+        if (is_statistics_enabled()){
+            m_statistics.record_database_load();
+        }
+    }
+
+    void load_database_file_untraced(const std::filesystem::path& database_file)
+    {
+        throw_exception_on_failure<magic_is_closed>(is_open());
+        throw_exception_on_failure<empty_path>(!database_file.empty());
+        throw_exception_on_failure<invalid_path>(std::filesystem::is_regular_file(database_file));
+        auto loaded_database_file = get_cached_database_file(database_file);
+        heap_counter libmagic_heap_counter;
+        const auto result = detail::magic_load(m_cookie.get(), loaded_database_file.c_str());
+        m_database_heap = heap_counter::add_to(m_database_heap, libmagic_heap_counter.allocated());
+        throw_exception_on_failure<magic_load_error>(result, database_file.c_str());
+        m_database_file = std::move(loaded_database_file);
+        m_database_buffer.clear();
+        build_dispatch_index();
+        if (is_statistics_enabled()){
+            m_statistics.record_database_load();
+        }
+    }
+
+    [[nodiscard]]
+    bool is_observed() const noexcept
+    {
+        return is_statistics_enabled() || (statistics_enabled && m_type_statistics_enabled) || is_traced();
+    }
+
+    [[nodiscard]]
+    bool is_traced() const noexcept
+    {
+        return m_trace_writer || m_span_tracer;
+    }
+
+    void begin_span(trace::call kind, std::string_view detail, clock_t::time_point start) const noexcept
+    {
+        if (m_span_tracer){
+            m_span_tracer->begin(trace::to_string(kind), detail, start);
+        }
+    }
+
+    void end_span(trace::call kind, clock_t::time_point end) const noexcept
+    {
+        if (m_span_tracer){
+            m_span_tracer->end(trace::to_string(kind), end);
+        }
+    }
+
+    /**
+     * @brief Records the statistics of an identification, writes its trace record if recording,
+     *        and ends its span if tracing.
+     *
+     * @note The size of the file is taken from the stat stage of the stage timing, so no
+     *       file is examined again, and it is zero if the stage timing is disabled.
+     */
+    void observe_identification(
+        trace::call kind, bool succeeded, clock_t::time_point start,
+        const std::filesystem::path& path, std::string_view file_type = {}) const noexcept
+    {
+        const auto end = clock_t::now();
+        if constexpr (statistics_enabled){
+            const auto size = succeeded ? m_identified_bytes : 0;
+            if (m_statistics_enabled){
+                m_statistics.record_call(end - start, succeeded, size);
+                if (!succeeded){
+                    m_statistics.record_error(
+                        !is_open() ? identification_error::magic_is_closed :
+                        path.empty() ? identification_error::empty_path : identification_error::magic_file_error
+                    );
+                }
+            }
+            if (succeeded && m_type_statistics_enabled){
+                m_statistics.record_type(get_type_key(file_type), end - start, size);
+            }
+        }
+        if (m_trace_writer){
+            m_trace_writer->write_file_record(kind, succeeded, m_flags_mask.to_ullong(), start, end, path);
+        }
+        end_span(kind, end);
+    }
+
+    /**
+     * @brief Returns the type of a file up to its first comma or semicolon, so the files of
+     *        the same type with different versions, sizes or charsets share the same key.
+     */
+    [[nodiscard]]
+    static std::string_view get_type_key(std::string_view file_type) noexcept
+    {
+        file_type = file_type.substr(0, file_type.find_first_of(",;"));
+        while (!file_type.empty() && file_type.back() == ' '){
+            file_type.remove_suffix(1);
+        }
+        return file_type;
+    }
+
+    void write_trace_record(
+        trace::call kind, bool succeeded,
+        clock_t::time_point start, const std::filesystem::path& path) const noexcept
+    {
+        const auto end = clock_t::now();
+        if (m_trace_writer){
+            m_trace_writer->write_file_record(kind, succeeded, m_flags_mask.to_ullong(), start, end, path);
+        }
+        end_span(kind, end);
+    }
+
+    void write_trace_record(
+        bool succeeded, clock_t::time_point start,
+        std::span<const char> database_buffer) const noexcept
+    {
+        const auto end = clock_t::now();
+        end_span(trace::call::load_database_buffer, end);
+        if (!m_trace_writer){
+            return;
+        }
+        m_trace_writer->write(trace::record{
+            .kind = trace::call::load_database_buffer,
+            .succeeded = succeeded,
+            .flags_mask = m_flags_mask.to_ullong(),
+            .offset = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_trace_writer->start()),
+            .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start),
+            .path = {},
+            .input_hash = trace::hash({database_buffer.data(), database_buffer.size()}),
+            .prefix = {}
+        });
+    }
+
+    /**
+     * @brief Gets the status of a file, follows the symbolic links if the symlink flag is set.
+     */
+    [[nodiscard]]
+    bool get_file_status(const std::filesystem::path& path, struct ::stat& status) const noexcept
+    {
+        const bool follow_symlink = (m_flags_mask & flags_mask_t{flags::symlink}).any();
+        return (follow_symlink ? ::stat(path.c_str(), &status) : ::lstat(path.c_str(), &status)) == 0;
+    }
+
+    /**
+     * @brief Used for testing whether a file is identified by its descriptor, which is true for
+     *        the regular files libmagic does not describe by their status, the empty and the
+     *        setuid, setgid and sticky files, unless the access times are preserved.
+     */
+    [[nodiscard]]
+    bool is_identified_by_descriptor(const struct ::stat& status) const noexcept
+    {
+        return S_ISREG(status.st_mode) && status.st_size > 0 &&
+               (status.st_mode & (S_ISUID | S_ISGID | S_ISVTX)) == 0 &&
+               (m_flags_mask & flags_mask_t{flags::preserve_atime}).none();
+    }
+
+    /**
+     * @brief Used for testing whether the regular files are identified using the dispatch index.
+     */
+    [[nodiscard]]
+    bool is_dispatched() const noexcept
+    {
+        return m_dispatch_index && (m_flags_mask & flags_mask_t{flags::compress}).none();
+    }
+
+    /**
+     * @brief Identifies the type of an open regular file, using the candidate sub database selected
+     *        by the dispatch index if it is enabled, returns nullptr if libmagic fails.
+     */
+    [[nodiscard]]
+    const char* identify_descriptor(int descriptor) const noexcept
+    {
+        return detail::magic_descriptor(get_dispatched_cookie(descriptor), descriptor);
+    }
+
+    /**
+     * @brief Returns the cookie of the candidate sub database selected by the dispatch index for
+     *        an open regular file, or the cookie of the full database if there is none.
+     *
+     * @note The first bytes are read with pread(), which leaves the file offset at the start of
+     *       the file for libmagic, so the file is opened once.
+     */
+    [[nodiscard]]
+    detail::magic_t get_dispatched_cookie(int descriptor) const noexcept
+    {
+        if (!is_dispatched()){
+            return m_cookie.get();
+        }
+        try {
+            std::array<unsigned char, dispatch_index::prefix_size> prefix{};
+            const auto prefix_length = std::min(prefix.size(), get_parameter(parameters::bytes_max));
+            std::size_t read_length{};
+            while (read_length < prefix_length){
+                const auto result = ::pread(
+                    descriptor, prefix.data() + read_length,
+                    prefix_length - read_length, static_cast<::off_t>(read_length)
+                );
+                if (result == 0){
+                    break;
+                }
+                if (result == -1){
+                    if (errno == EINTR){
+                        continue;
+                    }
+                    return m_cookie.get();
+                }
+                read_length += static_cast<std::size_t>(result);
+            }
+            auto key = m_dispatch_index->select(prefix);
+            auto cookie = key ? get_indexed_database_cookie(*key) : nullptr;
+            return cookie ? cookie : m_cookie.get();
+        } catch (...){
+            return m_cookie.get();
+        }
+    }
+
+    /**
+     * @brief Returns the cookie of the candidate sub database of the key,
+     *        loads it if it is not cached.
+     */
+    [[nodiscard]]
+    detail::magic_t get_indexed_database_cookie(const dispatch_index::key_t& key) const
+    {
+        auto indexed_database = m_indexed_databases.find(key);
+        if (is_statistics_enabled()){
+            m_statistics.record_cache_lookup(indexed_database != m_indexed_databases.end());
+        }
+        if (indexed_database == m_indexed_databases.end()){
+            if (m_indexed_databases.size() == max_indexed_databases){
+                m_indexed_databases.erase(std::ranges::min_element(m_indexed_databases, {},
+                    [](const auto& cached) {
+                        return cached.second.last_use;
+                    }
+                ));
+            }
+            indexed_database_t loaded{m_dispatch_index->extract(key), nullptr, 0};
+            loaded.cookie = open_database_cookie(loaded.database, m_flags_mask, loaded.libmagic_heap);
+            if (!loaded.cookie){
+                return nullptr;
+            }
+            indexed_database = m_indexed_databases.emplace(key, std::move(loaded)).first;
+        }
+        indexed_database->second.last_use = ++m_dispatch_count;
+        return indexed_database->second.cookie.get();
+    }
+
+    /**
+     * @brief Opens a cookie with the flags and the parameters of magic, and loads the compiled database.
+     *
+     * @note The database must outlive the cookie.
+     */
+    [[nodiscard]]
+    cookie_t open_database_cookie(std::vector<char>& database, flags_mask_t flags_mask, std::size_t& libmagic_heap) const
+    {
+        heap_counter libmagic_heap_counter;
+        cookie_t cookie{detail::magic_open(flags_converter(flags_mask))};
+        if (!cookie){
+            return nullptr;
+        }
+        for (const auto& libmagic_parameter : libmagic_parameters){
+            std::size_t value{};
+            detail::magic_getparam(m_cookie.get(), libmagic_pair_converter(libmagic_parameter), &value);
+            detail::magic_setparam(cookie.get(), libmagic_pair_converter(libmagic_parameter), &value);
+        }
+        void* buffers[]{database.data()};
+        std::size_t sizes[]{database.size()};
+        if (detail::magic_load_buffers(cookie.get(), buffers, sizes, 1) == libmagic_error){
+            return nullptr;
+        }
+        libmagic_heap = heap_counter::add_to(0, libmagic_heap_counter.allocated());
+        return cookie;
+    }
+
     [[nodiscard]]
     std::string get_error_message() const noexcept
     {
@@ -379,35 +1087,200 @@ private:
     friend std::string to_string(parameters);
 };
 
+namespace {
+
+/**
+ * @brief The size of the chunks written by write_to().
+ */
+constexpr std::size_t write_chunk_size{64 * 1024};
+
+/**
+ * @brief Appends the file and its type to the buffer.
+ */
+void append_type_of_a_file(
+    std::string& buffer, const std::filesystem::path& file,
+    const std::string& type_separator, const magic::file_type_t& file_type)
+{
+    buffer += file.native();
+    buffer += type_separator;
+    buffer += file_type;
+}
+
+/**
+ * @brief Appends the file and its expected type to the buffer.
+ */
+void append_type_of_a_file(
+    std::string& buffer, const std::filesystem::path& file,
+    const std::string& type_separator, const magic::expected_file_type_t& expected_file_type)
+{
+    buffer += file.native();
+    buffer += type_separator;
+    if (expected_file_type){
+        buffer += *expected_file_type;
+    } else {
+        buffer += expected_file_type.error().message(file);
+    }
+}
+
+/**
+ * @brief Gets the length of the string of the types of the files, the lengths of the
+ *        error messages are not counted.
+ */
+std::size_t get_string_length(
+    const auto& types_of_files,
+    const std::string& type_separator, const std::string& file_separator) noexcept
+{
+    if (types_of_files.empty()){
+        return 0;
+    }
+    auto length = (types_of_files.size() - 1) * file_separator.size()
+                + types_of_files.size() * type_separator.size();
+    for (const auto& [file, file_type] : types_of_files){
+        length += file.native().size();
+        if constexpr (std::same_as<std::remove_cvref_t<decltype(file_type)>, magic::file_type_t>){
+            length += file_type.size();
+        } else if (file_type){
+            length += file_type->size();
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief Appends the types of the files to the buffer, and passes the buffer to
+ *        the write function whenever it exceeds the chunk size.
+ *
+ * @returns False if the write function fails, true otherwise.
+ */
+bool append_types_of_files(
+    const auto& types_of_files,
+    const std::string& type_separator, const std::string& file_separator,
+    std::string& buffer, std::size_t chunk_size, auto&& write)
+{
+    auto first = true;
+    for (const auto& [file, file_type] : types_of_files){
+        if (!std::exchange(first, false)){
+            buffer += file_separator;
+        }
+        append_type_of_a_file(buffer, file, type_separator, file_type);
+        if (buffer.size() >= chunk_size){
+            if (!write(buffer)){
+                return false;
+            }
+            buffer.clear();
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Converts the types of the files to a string whose length is reserved beforehand.
+ */
+std::string types_of_files_to_string(
+    const auto& types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    std::string buffer;
+    buffer.reserve(get_string_length(types_of_files, type_separator, file_separator));
+    append_types_of_files(types_of_files, type_separator, file_separator, buffer,
+        std::numeric_limits<std::size_t>::max(), [](const std::string&){ return true; }
+    );
+    return buffer;
+}
+
+/**
+ * @brief Writes the types of the files to the stream in chunks.
+ */
+std::ostream& write_types_of_files(
+    std::ostream& stream, const auto& types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    const auto write = [&](const std::string& buffer){
+        return static_cast<bool>(stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size())));
+    };
+    std::string buffer;
+    buffer.reserve(write_chunk_size);
+    if (append_types_of_files(types_of_files, type_separator, file_separator, buffer, write_chunk_size, write)){
+        write(buffer);
+    }
+    return stream;
+}
+
+/**
+ * @brief Writes the types of the files to the file descriptor in chunks,
+ *        retrying the interrupted and the partial writes.
+ */
+bool write_types_of_files(
+    int file_descriptor, const auto& types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    const auto write = [&](const std::string& buffer){
+        std::string_view remaining{buffer};
+        while (!remaining.empty()){
+            const auto written = ::write(file_descriptor, remaining.data(), remaining.size());
+            if (written < 0){
+                if (errno == EINTR){
+                    continue;
+                }
+                return false;
+            }
+            remaining.remove_prefix(static_cast<std::size_t>(written));
+        }
+        return true;
+    };
+    std::string buffer;
+    buffer.reserve(write_chunk_size);
+    return append_types_of_files(types_of_files, type_separator, file_separator, buffer, write_chunk_size, write)
+        && write(buffer);
+}
+
+} /* namespace */
+
 std::string to_string(
     const magic::types_of_files_t& types_of_files,
     const std::string& type_separator, const std::string& file_separator)
 {
-    return utility::to_string(types_of_files, file_separator,
-        [&](const magic::types_of_files_t::value_type& type_of_a_file){
-            const auto& file = type_of_a_file.first;
-            const auto& file_type = type_of_a_file.second;
-            return file.string() + type_separator + file_type;
-        }
-    );
+    return types_of_files_to_string(types_of_files, type_separator, file_separator);
 }
 
-std::string to_string(const magic::expected_file_type_t& expected_file_type)
+std::string to_string(const magic::expected_file_type_t& expected_file_type, const std::filesystem::path& path)
 {
-    return expected_file_type.value_or(expected_file_type.error());
+    return expected_file_type ? *expected_file_type : expected_file_type.error().message(path);
 }
 
 std::string to_string(
     const magic::expected_types_of_files_t& expected_types_of_files,
     const std::string& type_separator, const std::string& file_separator)
 {
-    return utility::to_string(expected_types_of_files, file_separator,
-        [&](const magic::expected_types_of_files_t::value_type& type_of_a_file){
-            const auto& file = type_of_a_file.first;
-            const auto& expected_file_type = type_of_a_file.second;
-            return file.string() + type_separator + to_string(expected_file_type);
-        }
-    );
+    return types_of_files_to_string(expected_types_of_files, type_separator, file_separator);
+}
+
+std::ostream& write_to(
+    std::ostream& stream, const magic::types_of_files_t& types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    return write_types_of_files(stream, types_of_files, type_separator, file_separator);
+}
+
+std::ostream& write_to(
+    std::ostream& stream, const magic::expected_types_of_files_t& expected_types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    return write_types_of_files(stream, expected_types_of_files, type_separator, file_separator);
+}
+
+bool write_to(
+    int file_descriptor, const magic::types_of_files_t& types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    return write_types_of_files(file_descriptor, types_of_files, type_separator, file_separator);
+}
+
+bool write_to(
+    int file_descriptor, const magic::expected_types_of_files_t& expected_types_of_files,
+    const std::string& type_separator, const std::string& file_separator)
+{
+    return write_types_of_files(file_descriptor, expected_types_of_files, type_separator, file_separator);
 }
 
 std::string to_string(magic::flags flag)
@@ -451,6 +1324,12 @@ std::string to_string(
     );
 }
 
+[[nodiscard]]
+bool magic::native_path_less::operator()(std::string_view first, std::string_view second) const noexcept
+{
+    return results::compare_paths(first, second) < 0;
+}
+
 magic::magic() noexcept
     : m_impl{std::make_unique<magic_private>()}
 { }
@@ -496,12 +1375,44 @@ bool magic::compile(const std::filesystem::path& database_file) const noexcept
     return m_impl->compile(database_file);
 }
 
+void magic::enable_dispatch_index(bool enable) noexcept
+{
+    m_impl->enable_dispatch_index(enable);
+}
+
+void magic::enable_stage_timing(bool enable) noexcept
+{
+    m_impl->enable_stage_timing(enable);
+}
+
+void magic::enable_statistics(bool enable) noexcept
+{
+    m_impl->enable_statistics(enable);
+}
+
+void magic::enable_type_statistics(bool enable) noexcept
+{
+    m_impl->enable_type_statistics(enable);
+}
+
+[[nodiscard]]
+std::filesystem::path magic::get_compile_cache_directory() const
+{
+    return m_impl->get_compile_cache_directory();
+}
+
 [[nodiscard]]
 magic::flags_container_t magic::get_flags() const
 {
     return m_impl->get_flags();
 }
 
+[[nodiscard]]
+magic_memory_usage magic::get_memory_usage() const noexcept
+{
+    return m_impl->get_memory_usage();
+}
+
 [[nodiscard]]
 std::size_t magic::get_parameter(magic::parameters parameter) const
 {
@@ -514,6 +1425,24 @@ magic::parameter_value_map_t magic::get_parameters() const
     return m_impl->get_parameters();
 }
 
+[[nodiscard]]
+std::shared_ptr<trace::span_tracer> magic::get_span_tracer() const noexcept
+{
+    return m_impl->get_span_tracer();
+}
+
+[[nodiscard]]
+stage_durations_t magic::get_stage_durations() const noexcept
+{
+    return m_impl->get_stage_durations();
+}
+
+[[nodiscard]]
+magic_statistics magic::get_statistics() const noexcept
+{
+    return m_impl->get_statistics();
+}
+
 [[nodiscard]]
 std::string magic::get_version() noexcept
 {
@@ -533,12 +1462,47 @@ magic::expected_file_type_t
     return m_impl->identify_file(path, std::nothrow);
 }
 
+[[nodiscard]]
+bool magic::is_dispatch_index_enabled() const noexcept
+{
+    return m_impl->is_dispatch_index_enabled();
+}
+
 [[nodiscard]]
 bool magic::is_open() const noexcept
 {
     return m_impl->is_open();
 }
 
+[[nodiscard]]
+bool magic::is_recording() const noexcept
+{
+    return m_impl->is_recording();
+}
+
+[[nodiscard]]
+bool magic::is_stage_timing_enabled() const noexcept
+{
+    return m_impl->is_stage_timing_enabled();
+}
+
+[[nodiscard]]
+bool magic::is_statistics_enabled() const noexcept
+{
+    return m_impl->is_statistics_enabled();
+}
+
+[[nodiscard]]
+bool magic::is_type_statistics_enabled() const noexcept
+{
+    return m_impl->is_type_statistics_enabled();
+}
+
+void magic::load_database_buffer(std::span<const char> database_buffer)
+{
+    m_impl->load_database_buffer(database_buffer);
+}
+
 void magic::load_database_file(const std::filesystem::path& database_file)
 {
     m_impl->load_database_file(database_file);
@@ -554,6 +1518,21 @@ void magic::open(const flags_container_t& flags_container)
     m_impl->open(flags_container);
 }
 
+void magic::record_traversal(std::chrono::nanoseconds duration) const noexcept
+{
+    m_impl->record_traversal(duration);
+}
+
+void magic::reset_statistics() noexcept
+{
+    m_impl->reset_statistics();
+}
+
+void magic::set_compile_cache_directory(const std::filesystem::path& cache_directory)
+{
+    m_impl->set_compile_cache_directory(cache_directory);
+}
+
 void magic::set_flags(flags_mask_t flags_mask)
 {
     m_impl->set_flags(flags_mask);
@@ -574,4 +1553,19 @@ void magic::set_parameters(const parameter_value_map_t& parameters)
     m_impl->set_parameters(parameters);
 }
 
+void magic::set_span_tracer(std::shared_ptr<trace::span_tracer> span_tracer) noexcept
+{
+    m_impl->set_span_tracer(std::move(span_tracer));
+}
+
+void magic::start_recording(const std::filesystem::path& trace_file, std::size_t prefix_size)
+{
+    m_impl->start_recording(trace_file, prefix_size);
+}
+
+void magic::stop_recording() noexcept
+{
+    m_impl->stop_recording();
+}
+
 } /* namespace recognition */
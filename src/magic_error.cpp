@@ -0,0 +1,76 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <magic_error.hpp>
+#include <magic_exception.hpp>
+
+namespace recognition {
+
+namespace {
+
+/**
+ * @brief The magic_error_category class is the error category of the magic_errc enums.
+ */
+class magic_error_category final : public std::error_category {
+public:
+    [[nodiscard]]
+    const char* name() const noexcept override
+    {
+        return "magic";
+    }
+
+    [[nodiscard]]
+    std::string message(int errc) const override
+    {
+        switch (static_cast<magic_errc>(errc)){
+        case magic_errc::magic_is_closed:
+            return magic_is_closed{}.what();
+        case magic_errc::empty_path:
+            return empty_path{}.what();
+        case magic_errc::magic_file_error:
+            return "magic_file failed.";
+        }
+        return "unknown magic error.";
+    }
+};
+
+} /* namespace */
+
+const std::error_category& magic_category() noexcept
+{
+    static const magic_error_category category;
+    return category;
+}
+
+std::error_code make_error_code(magic_errc errc) noexcept
+{
+    return {static_cast<int>(errc), magic_category()};
+}
+
+magic_error::magic_error(magic_errc errc, int error_number, std::string_view description) noexcept
+    : m_errc{errc},
+      m_error_number{error_number}
+{
+    if (description.size() <= inline_description_capacity){
+        m_inline_description_size = description.copy(m_inline_description.data(), description.size());
+        return;
+    }
+    try {
+        m_description = std::make_shared<const std::string>(description);
+    } catch (...){
+    }
+}
+
+std::string magic_error::message(const std::filesystem::path& path) const
+{
+    if (m_errc != magic_errc::magic_file_error){
+        return magic_category().message(static_cast<int>(m_errc));
+    }
+    return magic_file_error{
+        !description().empty() ? std::string{description()} :
+        m_error_number == 0 ? std::string{} : std::generic_category().message(m_error_number),
+        path.string()
+    }.what();
+}
+
+} /* namespace recognition */
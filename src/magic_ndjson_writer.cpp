@@ -0,0 +1,150 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <cstring>
+#include <unistd.h>
+#include <string_view>
+
+#include <magic_exception.hpp>
+#include <magic_ndjson_writer.hpp>
+
+#include "json_string.hpp"
+
+namespace recognition {
+
+namespace {
+
+/**
+ * @brief The size of the chunks written by the ndjson_writer.
+ */
+constexpr std::size_t write_chunk_size{64 * 1024};
+
+/**
+ * @brief Appends a JSON string literal, or null if there is no string.
+ */
+void append_json_string_or_null(std::string& buffer, const std::string* string)
+{
+    if (!string){
+        buffer += "null";
+        return;
+    }
+    buffer += '"';
+    json::append_string(buffer, *string);
+    buffer += '"';
+}
+
+} /* namespace */
+
+ndjson_writer::ndjson_writer(const std::filesystem::path& output_file)
+    : m_file_descriptor{::open(output_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)},
+      m_owns_file_descriptor{true}
+{
+    if (m_file_descriptor < 0){
+        throw magic_output_error{std::strerror(errno), output_file.string()};
+    }
+    m_buffer.reserve(write_chunk_size);
+}
+
+ndjson_writer::ndjson_writer(int file_descriptor) noexcept
+    : m_file_descriptor{file_descriptor},
+      m_owns_file_descriptor{false}
+{
+    m_buffer.reserve(write_chunk_size);
+}
+
+ndjson_writer::~ndjson_writer()
+{
+    flush();
+    if (m_owns_file_descriptor){
+        ::close(m_file_descriptor);
+    }
+}
+
+bool ndjson_writer::flush() noexcept
+{
+    std::scoped_lock lock{m_mutex};
+    return flush_buffer();
+}
+
+bool ndjson_writer::good() const noexcept
+{
+    std::scoped_lock lock{m_mutex};
+    return m_good;
+}
+
+void ndjson_writer::identify_file(const magic& type_magic, const std::filesystem::path& path, const magic* mime_magic) noexcept
+{
+    const auto file_type = type_magic.identify_file(path, std::nothrow);
+    std::optional<magic::expected_file_type_t> mime;
+    if (mime_magic){
+        mime = mime_magic->identify_file(path, std::nothrow);
+    }
+    std::optional<std::uintmax_t> size;
+    std::error_code error_code;
+    if (!path.empty() && std::filesystem::is_regular_file(path, error_code)){
+        if (const auto file_size = std::filesystem::file_size(path, error_code); !error_code){
+            size = file_size;
+        }
+    }
+    write(path, file_type, mime ? &*mime : nullptr, size);
+}
+
+std::size_t ndjson_writer::record_count() const noexcept
+{
+    std::scoped_lock lock{m_mutex};
+    return m_record_count;
+}
+
+void ndjson_writer::write(
+    const std::filesystem::path& path,
+    const magic::expected_file_type_t& file_type,
+    const magic::expected_file_type_t* mime,
+    std::optional<std::uintmax_t> size) noexcept
+{
+    try {
+        std::string error;
+        if (!file_type){
+            error = file_type.error().message(path);
+        } else if (mime && !*mime){
+            error = mime->error().message(path);
+        }
+        std::scoped_lock lock{m_mutex};
+        m_buffer += "{\"path\":";
+        append_json_string_or_null(m_buffer, &path.native());
+        m_buffer += ",\"type\":";
+        append_json_string_or_null(m_buffer, file_type ? &*file_type : nullptr);
+        m_buffer += ",\"mime\":";
+        append_json_string_or_null(m_buffer, mime && *mime ? &**mime : nullptr);
+        m_buffer += ",\"error\":";
+        append_json_string_or_null(m_buffer, error.empty() ? nullptr : &error);
+        m_buffer += ",\"size\":";
+        m_buffer += size ? std::to_string(*size) : "null";
+        m_buffer += "}\n";
+        ++m_record_count;
+        if (m_buffer.size() >= write_chunk_size){
+            flush_buffer();
+        }
+    } catch (...){
+        std::scoped_lock lock{m_mutex};
+        m_good = false;
+    }
+}
+
+bool ndjson_writer::flush_buffer() noexcept
+{
+    std::string_view remaining{m_buffer};
+    while (m_good && !remaining.empty()){
+        const auto written = ::write(m_file_descriptor, remaining.data(), remaining.size());
+        if (written < 0){
+            m_good = (errno == EINTR);
+            continue;
+        }
+        remaining.remove_prefix(static_cast<std::size_t>(written));
+    }
+    m_buffer.clear();
+    return m_good;
+}
+
+} /* namespace recognition */
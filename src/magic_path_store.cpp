@@ -0,0 +1,207 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <stdexcept>
+
+#include <magic_path_store.hpp>
+
+#include "binary_encoding.hpp"
+
+namespace recognition {
+
+namespace {
+
+/**
+ * @brief The initial number of the slots of the hash table of the children.
+ */
+constexpr std::size_t initial_slot_count{1024};
+
+/**
+ * @brief Gets the FNV-1a hash of the id of the parent and the name of a node.
+ */
+[[nodiscard]]
+std::uint64_t hash(path_store::path_id_t parent, std::string_view name) noexcept
+{
+    return binary::hash(name, (binary::fnv_offset_basis ^ parent) * binary::fnv_prime);
+}
+
+} /* namespace */
+
+path_store::path_store()
+    : m_nodes{{empty_path_id, 0, 0}},
+      m_children(initial_slot_count, empty_path_id)
+{ }
+
+std::filesystem::path path_store::get_path(path_id_t path_id) const
+{
+    if (path_id >= m_nodes.size()){
+        throw std::out_of_range{"path_store::get_path"};
+    }
+    std::vector<path_id_t> components;
+    std::size_t length{};
+    for (auto node = path_id; node != empty_path_id; node = m_nodes[node].parent){
+        components.push_back(node);
+        length += m_nodes[node].name_size + 1;
+    }
+    if (components.empty()){
+        return {};
+    }
+    std::string path;
+    path.reserve(length);
+    const auto is_absolute = get_name(components.back()) == "/";
+    for (std::size_t depth{}; auto component : components | std::views::reverse){
+        if (depth != 0 && !(depth == 1 && is_absolute)){
+            path += '/';
+        }
+        path += get_name(component);
+        ++depth;
+    }
+    return path;
+}
+
+path_store::path_id_t path_store::insert(const std::filesystem::path& path)
+{
+    std::string_view remaining{path.native()};
+    auto node = empty_path_id;
+    if (remaining.empty()){
+        return node;
+    }
+    if (remaining.starts_with('/')){
+        node = insert_child(node, "/");
+        remaining.remove_prefix(1);
+        if (remaining.empty()){
+            return node;
+        }
+    }
+    while (true){
+        const auto separator = remaining.find('/');
+        node = insert_child(node, remaining.substr(0, separator));
+        if (separator == std::string_view::npos){
+            return node;
+        }
+        remaining.remove_prefix(separator + 1);
+    }
+}
+
+std::size_t path_store::memory_usage() const noexcept
+{
+    return sizeof(*this)
+         + m_names.capacity()
+         + m_nodes.capacity() * sizeof(node_t)
+         + m_children.capacity() * sizeof(path_id_t);
+}
+
+std::size_t path_store::size() const noexcept
+{
+    return m_nodes.size();
+}
+
+std::string_view path_store::get_name(path_id_t path_id) const noexcept
+{
+    const auto& node = m_nodes[path_id];
+    return std::string_view{m_names}.substr(node.name_offset, node.name_size);
+}
+
+path_store::path_id_t path_store::insert_child(path_id_t parent, std::string_view name)
+{
+    const auto mask = m_children.size() - 1;
+    for (auto slot = hash(parent, name) & mask; ; slot = (slot + 1) & mask){
+        const auto child = m_children[slot];
+        if (child == empty_path_id){
+            if (m_nodes.size() > std::numeric_limits<path_id_t>::max()
+                || m_names.size() + name.size() > std::numeric_limits<std::uint32_t>::max()){
+                throw std::length_error{"path_store::insert"};
+            }
+            const auto path_id = static_cast<path_id_t>(m_nodes.size());
+            m_nodes.push_back({parent, static_cast<std::uint32_t>(m_names.size()), static_cast<std::uint32_t>(name.size())});
+            m_names.append(name);
+            m_children[slot] = path_id;
+            if (2 * m_nodes.size() > m_children.size()){
+                grow_children();
+            }
+            return path_id;
+        }
+        if (m_nodes[child].parent == parent && get_name(child) == name){
+            return child;
+        }
+    }
+}
+
+void path_store::grow_children()
+{
+    std::vector<path_id_t> children(2 * m_children.size(), empty_path_id);
+    const auto mask = children.size() - 1;
+    for (path_id_t path_id{1}; path_id < m_nodes.size(); ++path_id){
+        auto slot = hash(m_nodes[path_id].parent, get_name(path_id)) & mask;
+        while (children[slot] != empty_path_id){
+            slot = (slot + 1) & mask;
+        }
+        children[slot] = path_id;
+    }
+    m_children = std::move(children);
+}
+
+const std::vector<compact_types_of_files::entry_t>& compact_types_of_files::entries() const noexcept
+{
+    return m_entries;
+}
+
+std::filesystem::path compact_types_of_files::get_path(std::size_t index) const
+{
+    return m_paths.get_path(m_entries.at(index).path_id);
+}
+
+const path_store& compact_types_of_files::get_path_store() const noexcept
+{
+    return m_paths;
+}
+
+std::string_view compact_types_of_files::get_type(std::size_t index) const
+{
+    return m_types[m_entries.at(index).type_id];
+}
+
+const std::vector<std::string_view>& compact_types_of_files::get_types() const noexcept
+{
+    return m_types;
+}
+
+void compact_types_of_files::insert(const std::filesystem::path& path, std::string_view file_type)
+{
+    auto type_id = m_type_ids.find(file_type);
+    if (type_id == m_type_ids.end()){
+        type_id = m_type_ids.emplace(file_type, static_cast<type_id_t>(m_types.size())).first;
+        m_types.push_back(type_id->first);
+    }
+    m_entries.push_back({m_paths.insert(path), type_id->second});
+}
+
+std::size_t compact_types_of_files::memory_usage() const noexcept
+{
+    auto usage = sizeof(*this) - sizeof(m_paths) + m_paths.memory_usage()
+               + m_entries.capacity() * sizeof(entry_t)
+               + m_types.capacity() * sizeof(std::string_view);
+    for (const auto& [type, type_id] : m_type_ids){
+        usage += 4 * sizeof(void*) + sizeof(type) + type.capacity() + sizeof(type_id);
+    }
+    return usage;
+}
+
+std::size_t compact_types_of_files::size() const noexcept
+{
+    return m_entries.size();
+}
+
+magic::types_of_files_t compact_types_of_files::to_types_of_files() const
+{
+    magic::types_of_files_t types_of_files;
+    for (const auto& [path_id, type_id] : m_entries){
+        types_of_files.insert_or_assign(m_paths.get_path(path_id), std::string{m_types[type_id]});
+    }
+    return types_of_files;
+}
+
+} /* namespace recognition */
@@ -0,0 +1,413 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#include <magic_results.hpp>
+#include <magic_exception.hpp>
+
+#include "mapped_file.hpp"
+#include "binary_encoding.hpp"
+
+namespace recognition::results {
+
+using namespace binary;
+
+namespace {
+
+/**
+ * @brief The type code of the records whose identification failed.
+ */
+constexpr std::uint32_t no_type_code{std::numeric_limits<std::uint32_t>::max()};
+
+/**
+ * @brief The size of the records whose size is unknown.
+ */
+constexpr std::uint64_t no_size{std::numeric_limits<std::uint64_t>::max()};
+
+/**
+ * @brief The size of the trailer, the offset of the footer followed by the signature.
+ */
+constexpr std::size_t trailer_size{sizeof(std::uint64_t) + signature.size()};
+
+/**
+ * @brief Get the code of a string interned in a dictionary, intern it if it is not interned.
+ */
+[[nodiscard]]
+std::uint32_t intern(
+    std::map<std::string, std::uint32_t, std::less<>>& codes,
+    std::vector<std::string_view>& strings,
+    std::string_view string)
+{
+    auto code = codes.find(string);
+    if (code == codes.end()){
+        code = codes.emplace(string, static_cast<std::uint32_t>(strings.size())).first;
+        strings.push_back(code->first);
+    }
+    return code->second;
+}
+
+/**
+ * @brief Append a dictionary, its size, the end offsets of its strings and the strings.
+ */
+void write_dictionary(std::string& buffer, const std::vector<std::string_view>& strings)
+{
+    write_integer(buffer, static_cast<std::uint32_t>(strings.size()));
+    std::uint32_t offset{};
+    write_integer(buffer, offset);
+    for (auto string : strings){
+        offset += static_cast<std::uint32_t>(string.size());
+        write_integer(buffer, offset);
+    }
+    for (auto string : strings){
+        buffer.append(string);
+    }
+}
+
+/**
+ * @brief Read a dictionary written by write_dictionary().
+ *
+ * @throws std::out_of_range    if the dictionary is truncated or malformed.
+ */
+[[nodiscard]]
+std::vector<std::string_view> read_dictionary(cursor& footer)
+{
+    const auto count = footer.read<std::uint32_t>();
+    const auto offsets = footer.skip((static_cast<std::uint64_t>(count) + 1) * sizeof(std::uint32_t));
+    const auto data = footer.skip(read_integer<std::uint32_t>(offsets, count));
+    std::vector<std::string_view> strings;
+    strings.reserve(count);
+    for (std::size_t code{}; code < count; ++code){
+        const auto begin = read_integer<std::uint32_t>(offsets, code);
+        const auto end = read_integer<std::uint32_t>(offsets, code + 1);
+        if (begin > end){
+            throw std::out_of_range{"dictionary"};
+        }
+        strings.emplace_back(data + begin, end - begin);
+    }
+    return strings;
+}
+
+} /* namespace */
+
+writer::writer(const std::filesystem::path& results_file)
+    : m_file{results_file},
+      m_stream{results_file, std::ios::binary | std::ios::trunc}
+{
+    if (!m_stream){
+        throw magic_results_error{"failed to create the results file", results_file.string()};
+    }
+    std::string header{signature};
+    header.push_back(static_cast<char>(version));
+    write_bytes(header);
+}
+
+writer::~writer()
+{
+    try {
+        close();
+    } catch (...){
+    }
+}
+
+void writer::close()
+{
+    if (!m_stream.is_open()){
+        return;
+    }
+    write_block();
+    const auto footer_offset = m_offset;
+    std::string footer;
+    write_dictionary(footer, m_types);
+    write_dictionary(footer, m_descriptions);
+    write_integer(footer, static_cast<std::uint64_t>(m_record_count));
+    write_integer(footer, static_cast<std::uint32_t>(block_size));
+    write_integer(footer, static_cast<std::uint64_t>(m_block_offsets.size()));
+    write_integers(footer, m_block_offsets);
+    write_integer(footer, footer_offset);
+    footer.append(signature);
+    write_bytes(footer);
+    m_stream.close();
+    if (!m_stream){
+        throw magic_results_error{"failed to close the results file", m_file.string()};
+    }
+}
+
+const std::filesystem::path& writer::file() const noexcept
+{
+    return m_file;
+}
+
+void writer::identify_file(const magic& type_magic, const std::filesystem::path& path)
+{
+    const auto file_type = type_magic.identify_file(path, std::nothrow);
+    std::optional<std::uint64_t> size;
+    std::error_code error_code;
+    if (!path.empty() && std::filesystem::is_regular_file(path, error_code)){
+        if (const auto file_size = std::filesystem::file_size(path, error_code); !error_code){
+            size = file_size;
+        }
+    }
+    write(path, file_type, size);
+}
+
+std::size_t writer::record_count() const noexcept
+{
+    return m_record_count;
+}
+
+void writer::write(
+    const std::filesystem::path& path,
+    const magic::expected_file_type_t& file_type,
+    std::optional<std::uint64_t> size)
+{
+    if (!m_stream.is_open()){
+        throw magic_results_error{"the results file is closed", m_file.string()};
+    }
+    const std::string_view current_path{path.native()};
+    std::size_t shared_size{};
+    if (m_type_codes.size() % restart_interval == 0){
+        m_restarts.push_back(static_cast<std::uint32_t>(m_paths.size()));
+    } else {
+        shared_size = std::ranges::mismatch(current_path, m_previous_path).in1 - current_path.begin();
+    }
+    write_variable_integer(m_paths, shared_size);
+    write_variable_integer(m_paths, current_path.size() - shared_size);
+    m_paths.append(current_path.substr(shared_size));
+    m_previous_path.assign(current_path);
+    if (file_type){
+        m_type_codes.push_back(intern(m_type_codes_by_type, m_types, *file_type));
+        m_errors.push_back(0);
+    } else {
+        const auto description = file_type.error().description();
+        m_type_codes.push_back(
+            description.empty() ? no_type_code : intern(m_description_codes_by_description, m_descriptions, description)
+        );
+        m_errors.push_back(encode_error(file_type.error()));
+    }
+    m_sizes.push_back(size.value_or(no_size));
+    ++m_record_count;
+    if (m_type_codes.size() == block_size){
+        write_block();
+    }
+}
+
+void writer::write_block()
+{
+    if (m_type_codes.empty()){
+        return;
+    }
+    m_block_offsets.push_back(m_offset);
+    std::string block;
+    block.reserve(3 * sizeof(std::uint32_t) + m_restarts.size() * sizeof(std::uint32_t) + m_paths.size()
+        + m_type_codes.size() * (2 * sizeof(std::uint32_t) + sizeof(std::uint64_t))
+    );
+    write_integer(block, static_cast<std::uint32_t>(m_type_codes.size()));
+    write_integer(block, static_cast<std::uint32_t>(m_paths.size()));
+    write_integer(block, static_cast<std::uint32_t>(m_restarts.size()));
+    write_integers(block, m_restarts);
+    block.append(m_paths);
+    write_integers(block, m_type_codes);
+    write_integers(block, m_errors);
+    write_integers(block, m_sizes);
+    write_bytes(block);
+    m_previous_path.clear();
+    m_paths.clear();
+    m_restarts.clear();
+    m_type_codes.clear();
+    m_errors.clear();
+    m_sizes.clear();
+}
+
+void writer::write_bytes(std::string_view bytes)
+{
+    if (!m_stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()))){
+        throw magic_results_error{"failed to write the results file", m_file.string()};
+    }
+    m_offset += bytes.size();
+}
+
+reader::reader(const std::filesystem::path& results_file)
+{
+    try {
+        const auto contents = map_file(results_file);
+        m_data = contents.data();
+        m_size = contents.size();
+    } catch (const std::system_error& error){
+        throw magic_results_error{error.code().message(), results_file.string()};
+    }
+    try {
+        parse(results_file);
+    } catch (...){
+        unmap_file({m_data, m_size});
+        throw;
+    }
+}
+
+reader::reader(reader&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_record_count{std::exchange(other.m_record_count, 0)},
+      m_types{std::move(other.m_types)},
+      m_descriptions{std::move(other.m_descriptions)},
+      m_blocks{std::move(other.m_blocks)}
+{ }
+
+reader& reader::operator=(reader&& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_record_count, other.m_record_count);
+    std::swap(m_types, other.m_types);
+    std::swap(m_descriptions, other.m_descriptions);
+    std::swap(m_blocks, other.m_blocks);
+    return *this;
+}
+
+reader::~reader()
+{
+    unmap_file({m_data, m_size});
+}
+
+record reader::at(std::size_t index) const
+{
+    if (index >= m_record_count){
+        throw std::out_of_range{"results::reader::at"};
+    }
+    const auto& block = m_blocks[index / block_size];
+    const auto index_in_block = index % block_size;
+    const auto paths_end = block.paths + block.paths_size;
+    auto paths = block.paths + read_integer<std::uint32_t>(block.restarts, index_in_block / restart_interval);
+    std::string path;
+    for (auto i = index_in_block - index_in_block % restart_interval; i <= index_in_block; ++i){
+        const auto shared_size = read_variable_integer(paths, paths_end);
+        const auto suffix_size = read_variable_integer(paths, paths_end);
+        if (shared_size > path.size() || suffix_size > static_cast<std::size_t>(paths_end - paths)){
+            throw std::out_of_range{"results::reader::at"};
+        }
+        path.resize(shared_size);
+        path.append(paths, suffix_size);
+        paths += suffix_size;
+    }
+    const auto type_code = read_integer<std::uint32_t>(block.type_codes, index_in_block);
+    const auto error = read_integer<std::uint32_t>(block.errors, index_in_block);
+    const auto size = read_integer<std::uint64_t>(block.sizes, index_in_block);
+    record result{
+        std::move(path),
+        std::unexpected{decode_error(error, error != 0 && type_code < m_descriptions.size() ? m_descriptions[type_code] : "")},
+        size == no_size ? std::nullopt : std::optional{size}
+    };
+    if (error == 0 && type_code < m_types.size()){
+        result.type = m_types[type_code];
+    }
+    return result;
+}
+
+std::vector<std::size_t> reader::find(std::string_view type) const
+{
+    std::vector<bool> matching_codes(m_types.size());
+    for (std::size_t code{}; code < m_types.size(); ++code){
+        matching_codes[code] = m_types[code] == type;
+    }
+    return find_codes(matching_codes);
+}
+
+std::vector<std::size_t> reader::find_if(const std::function<bool(std::string_view)>& predicate) const
+{
+    std::vector<bool> matching_codes(m_types.size());
+    for (std::size_t code{}; code < m_types.size(); ++code){
+        matching_codes[code] = predicate(m_types[code]);
+    }
+    return find_codes(matching_codes);
+}
+
+void reader::for_each_type(const std::function<void(std::size_t, std::string_view)>& function) const
+{
+    for (const auto& block : m_blocks){
+        for (std::size_t i{}; i < block.count; ++i){
+            const auto type_code = read_integer<std::uint32_t>(block.type_codes, i);
+            if (type_code < m_types.size() && read_integer<std::uint32_t>(block.errors, i) == 0){
+                function(block.first + i, m_types[type_code]);
+            }
+        }
+    }
+}
+
+std::size_t reader::size() const noexcept
+{
+    return m_record_count;
+}
+
+const std::vector<std::string_view>& reader::types() const noexcept
+{
+    return m_types;
+}
+
+void reader::parse(const std::filesystem::path& results_file)
+{
+    try {
+        if (m_size < signature.size() + 1 + trailer_size
+            || std::string_view{m_data, signature.size()} != signature
+            || static_cast<std::uint8_t>(m_data[signature.size()]) != version
+            || std::string_view{m_data + m_size - signature.size(), signature.size()} != signature){
+            throw std::out_of_range{"signature"};
+        }
+        cursor footer{m_data, m_size - trailer_size, read_integer<std::uint64_t>(m_data + m_size - trailer_size)};
+        m_types = read_dictionary(footer);
+        m_descriptions = read_dictionary(footer);
+        m_record_count = footer.read<std::uint64_t>();
+        if (footer.read<std::uint32_t>() != block_size){
+            throw std::out_of_range{"block size"};
+        }
+        const auto block_count = footer.read<std::uint64_t>();
+        const auto block_offsets = footer.skip(block_count * sizeof(std::uint64_t));
+        if (block_count != (m_record_count + block_size - 1) / block_size){
+            throw std::out_of_range{"block count"};
+        }
+        m_blocks.reserve(block_count);
+        for (std::size_t i{}; i < block_count; ++i){
+            cursor block{m_data, m_size - trailer_size, read_integer<std::uint64_t>(block_offsets, i)};
+            const std::size_t count{block.read<std::uint32_t>()};
+            const std::size_t paths_size{block.read<std::uint32_t>()};
+            const std::size_t restart_count{block.read<std::uint32_t>()};
+            const auto expected_count = i + 1 == block_count ? m_record_count - i * block_size : block_size;
+            if (count != expected_count || restart_count != (count + restart_interval - 1) / restart_interval){
+                throw std::out_of_range{"block"};
+            }
+            const auto restarts = block.skip(restart_count * sizeof(std::uint32_t));
+            const auto paths = block.skip(paths_size);
+            const auto type_codes = block.skip(count * sizeof(std::uint32_t));
+            const auto errors = block.skip(count * sizeof(std::uint32_t));
+            const auto sizes = block.skip(count * sizeof(std::uint64_t));
+            for (std::size_t j{}; j < restart_count; ++j){
+                if (read_integer<std::uint32_t>(restarts, j) > paths_size){
+                    throw std::out_of_range{"restart"};
+                }
+            }
+            m_blocks.push_back({i * block_size, count, restarts, paths, paths_size, type_codes, errors, sizes});
+        }
+    } catch (const std::out_of_range&){
+        throw magic_results_error{"malformed results file", results_file.string()};
+    }
+}
+
+std::vector<std::size_t> reader::find_codes(const std::vector<bool>& matching_codes) const
+{
+    std::vector<std::size_t> indexes;
+    for (const auto& block : m_blocks){
+        for (std::size_t i{}; i < block.count; ++i){
+            const auto type_code = read_integer<std::uint32_t>(block.type_codes, i);
+            if (type_code < matching_codes.size() && matching_codes[type_code] &&
+                read_integer<std::uint32_t>(block.errors, i) == 0){
+                indexes.push_back(block.first + i);
+            }
+        }
+    }
+    return indexes;
+}
+
+} /* namespace recognition::results */
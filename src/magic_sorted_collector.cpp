@@ -0,0 +1,460 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <span>
+#include <atomic>
+#include <format>
+#include <limits>
+#include <fstream>
+#include <utility>
+#include <unistd.h>
+#include <algorithm>
+#include <system_error>
+
+#include <magic_exception.hpp>
+#include <magic_sorted_collector.hpp>
+
+#include "binary_encoding.hpp"
+
+namespace recognition::results {
+
+using namespace binary;
+
+namespace {
+
+/**
+ * @brief The size of the record whose size is unknown.
+ */
+constexpr std::uint64_t no_size{std::numeric_limits<std::uint64_t>::max()};
+
+/**
+ * @brief The size of the chunks written to the run files.
+ */
+constexpr std::size_t write_chunk_size{64 * 1024};
+
+/**
+ * @brief The path_elements class iterates the elements of the relative path of a native
+ *        path, like std::filesystem::path::iterator, the trailing separator is an empty element.
+ */
+class path_elements {
+public:
+    explicit path_elements(std::string_view path) noexcept
+        : m_rest{path}
+    {
+        m_rest.remove_prefix(std::min(m_rest.find_first_not_of('/'), m_rest.size()));
+    }
+
+    [[nodiscard]]
+    std::optional<std::string_view> next() noexcept
+    {
+        if (m_rest.empty()){
+            if (std::exchange(m_trailing_separator, false)){
+                return std::string_view{};
+            }
+            return std::nullopt;
+        }
+        const auto separator = m_rest.find('/');
+        const auto element = m_rest.substr(0, separator);
+        const auto next_element = m_rest.find_first_not_of('/', separator);
+        if (separator != std::string_view::npos && next_element == std::string_view::npos){
+            m_trailing_separator = true;
+        }
+        m_rest.remove_prefix(std::min(next_element, m_rest.size()));
+        return element;
+    }
+
+private:
+    std::string_view m_rest;
+    bool m_trailing_separator{false};
+};
+
+/**
+ * @brief The run_record struct is a record of a run file.
+ */
+struct run_record {
+    std::string path;
+    std::string type;
+    std::uint32_t error;
+    std::uint64_t size;
+};
+
+/**
+ * @brief The run_writer class writes the records of a run file in chunks.
+ *
+ * @note A record is the LEB128 encoded size of the path, the path, the encoded error,
+ *       the size of the type and the type, or the description of the error, and the size
+ *       of the file plus 1, 0 if it is unknown.
+ */
+class run_writer {
+public:
+    explicit run_writer(const std::filesystem::path& run_file)
+        : m_file{run_file},
+          m_stream{run_file, std::ios::binary | std::ios::trunc}
+    {
+        if (!m_stream){
+            throw magic_output_error{"failed to create the run file", run_file.string()};
+        }
+        m_buffer.reserve(write_chunk_size);
+    }
+
+    void write(std::string_view path, std::string_view type, std::uint32_t error, std::uint64_t size)
+    {
+        write_variable_integer(m_buffer, path.size());
+        m_buffer.append(path);
+        write_variable_integer(m_buffer, error);
+        write_variable_integer(m_buffer, type.size());
+        m_buffer.append(type);
+        write_variable_integer(m_buffer, size == no_size ? 0 : size + 1);
+        if (m_buffer.size() >= write_chunk_size){
+            flush();
+        }
+    }
+
+    void close()
+    {
+        flush();
+        m_stream.close();
+        if (!m_stream){
+            throw magic_output_error{"failed to close the run file", m_file.string()};
+        }
+    }
+
+private:
+    std::filesystem::path m_file;
+    std::ofstream m_stream;
+    std::string m_buffer;
+
+    void flush()
+    {
+        if (!m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()))){
+            throw magic_output_error{"failed to write the run file", m_file.string()};
+        }
+        m_buffer.clear();
+    }
+};
+
+/**
+ * @brief The run_reader class reads the records of a run file one by one.
+ */
+class run_reader {
+public:
+    explicit run_reader(const std::filesystem::path& run_file)
+        : m_file{run_file},
+          m_stream{run_file, std::ios::binary}
+    {
+        if (!m_stream){
+            throw magic_output_error{"failed to open the run file", run_file.string()};
+        }
+    }
+
+    /**
+     * @brief Read the next record, false if there is no record left.
+     */
+    [[nodiscard]]
+    bool next()
+    {
+        if (m_stream.peek() == std::ifstream::traits_type::eof()){
+            return false;
+        }
+        read_string(m_record.path);
+        m_record.error = static_cast<std::uint32_t>(read_integer());
+        read_string(m_record.type);
+        const auto size = read_integer();
+        m_record.size = size == 0 ? no_size : size - 1;
+        return true;
+    }
+
+    [[nodiscard]]
+    const run_record& get_record() const noexcept
+    {
+        return m_record;
+    }
+
+private:
+    std::filesystem::path m_file;
+    std::ifstream m_stream;
+    run_record m_record;
+
+    [[nodiscard]]
+    std::uint64_t read_integer()
+    {
+        auto value = read_variable_integer(
+            [this]{
+                return m_stream.rdbuf()->sbumpc();
+            }
+        );
+        if (!value){
+            throw magic_output_error{"malformed run file", m_file.string()};
+        }
+        return *value;
+    }
+
+    void read_string(std::string& string)
+    {
+        const auto size = read_integer();
+        string.resize(size);
+        if (!m_stream.read(string.data(), static_cast<std::streamsize>(size))){
+            throw magic_output_error{"malformed run file", m_file.string()};
+        }
+    }
+};
+
+/**
+ * @brief Merge the sorted runs with a k-way merge, calling the function with the last record
+ *        of each path, the records of the later runs replace the records of the earlier ones.
+ */
+void merge(std::span<const std::filesystem::path> runs, const std::function<void(const run_record&)>& function)
+{
+    std::vector<run_reader> readers;
+    readers.reserve(runs.size());
+    for (const auto& run : runs){
+        readers.emplace_back(run);
+    }
+    const auto greater = [&](std::size_t first, std::size_t second){
+        const auto order = compare_paths(readers[first].get_record().path, readers[second].get_record().path);
+        return order != 0 ? order > 0 : first > second;
+    };
+    std::vector<std::size_t> heap;
+    for (std::size_t i{}; i < readers.size(); ++i){
+        if (readers[i].next()){
+            heap.push_back(i);
+        }
+    }
+    std::ranges::make_heap(heap, greater);
+    while (!heap.empty()){
+        std::ranges::pop_heap(heap, greater);
+        const auto i = heap.back();
+        heap.pop_back();
+        const auto& current = readers[i].get_record();
+        if (heap.empty() || compare_paths(readers[heap.front()].get_record().path, current.path) != 0){
+            function(current);
+        }
+        if (readers[i].next()){
+            heap.push_back(i);
+            std::ranges::push_heap(heap, greater);
+        }
+    }
+}
+
+[[nodiscard]]
+record make_record(std::string_view path, std::string_view type, std::uint32_t error, std::uint64_t size)
+{
+    record result{
+        path,
+        std::unexpected{decode_error(error, error == 0 ? std::string_view{} : type)},
+        size == no_size ? std::nullopt : std::optional{size}
+    };
+    if (error == 0){
+        result.type = type;
+    }
+    return result;
+}
+
+} /* namespace */
+
+std::strong_ordering compare_paths(std::string_view first, std::string_view second) noexcept
+{
+    const auto first_has_root_directory = first.starts_with('/');
+    if (const auto order = first_has_root_directory <=> second.starts_with('/'); order != 0){
+        return order;
+    }
+    path_elements first_elements{first};
+    path_elements second_elements{second};
+    while (true){
+        const auto first_element = first_elements.next();
+        const auto second_element = second_elements.next();
+        if (!first_element || !second_element){
+            return first_element.has_value() <=> second_element.has_value();
+        }
+        if (const auto order = *first_element <=> *second_element; order != 0){
+            return order;
+        }
+    }
+}
+
+sorted_collector::sorted_collector(std::size_t memory_budget, const std::filesystem::path& temporary_directory)
+    : m_memory_budget{memory_budget},
+      m_temporary_directory{temporary_directory},
+      m_collector_id{[]{
+          static std::atomic<std::size_t> collector_count{};
+          return collector_count++;
+      }()}
+{ }
+
+sorted_collector::~sorted_collector()
+{
+    for (const auto& run : m_runs){
+        std::error_code error_code;
+        std::filesystem::remove(run, error_code);
+    }
+}
+
+void sorted_collector::for_each(const std::function<void(const record&)>& function)
+{
+    if (m_runs.empty()){
+        sort_entries();
+        for (const auto& entry : m_entries){
+            function(make_record(
+                get_path(entry), {m_bytes.data() + entry.offset + entry.path_size, entry.type_size},
+                entry.error, entry.size
+            ));
+        }
+        return;
+    }
+    spill();
+    while (m_runs.size() > merge_width){
+        merge_runs();
+    }
+    merge(m_runs,
+        [&](const run_record& current){
+            function(make_record(current.path, current.type, current.error, current.size));
+        }
+    );
+}
+
+void sorted_collector::identify_file(const magic& type_magic, const std::filesystem::path& path)
+{
+    const auto file_type = type_magic.identify_file(path, std::nothrow);
+    std::optional<std::uint64_t> size;
+    std::error_code error_code;
+    if (!path.empty() && std::filesystem::is_regular_file(path, error_code)){
+        if (const auto file_size = std::filesystem::file_size(path, error_code); !error_code){
+            size = file_size;
+        }
+    }
+    insert(path, file_type, size);
+}
+
+void sorted_collector::insert(
+    const std::filesystem::path& path,
+    const magic::expected_file_type_t& file_type,
+    std::optional<std::uint64_t> size)
+{
+    const std::string_view current_path{path.native()};
+    const std::string_view current_type{file_type ? std::string_view{*file_type} : file_type.error().description()};
+    m_entries.push_back({
+        m_bytes.size(),
+        static_cast<std::uint32_t>(current_path.size()),
+        static_cast<std::uint32_t>(current_type.size()),
+        file_type ? 0 : encode_error(file_type.error()),
+        size.value_or(no_size)
+    });
+    m_bytes.append(current_path);
+    m_bytes.append(current_type);
+    ++m_record_count;
+    if (memory_usage() >= m_memory_budget){
+        spill();
+    }
+}
+
+std::size_t sorted_collector::memory_usage() const noexcept
+{
+    return m_bytes.size() + m_entries.size() * sizeof(entry_t);
+}
+
+std::size_t sorted_collector::record_count() const noexcept
+{
+    return m_record_count;
+}
+
+std::size_t sorted_collector::run_count() const noexcept
+{
+    return m_runs.size();
+}
+
+void sorted_collector::write(writer& results_writer)
+{
+    for_each(
+        [&](const record& current){
+            if (current.type){
+                results_writer.write(current.path, std::string{*current.type}, current.size);
+            } else {
+                results_writer.write(current.path, std::unexpected{current.type.error()}, current.size);
+            }
+        }
+    );
+}
+
+std::string_view sorted_collector::get_path(const entry_t& entry) const noexcept
+{
+    return {m_bytes.data() + entry.offset, entry.path_size};
+}
+
+void sorted_collector::sort_entries()
+{
+    std::ranges::stable_sort(m_entries,
+        [&](const entry_t& first, const entry_t& second){
+            return compare_paths(get_path(first), get_path(second)) < 0;
+        }
+    );
+    const auto replaced = std::ranges::unique(m_entries.rbegin(), m_entries.rend(),
+        [&](const entry_t& first, const entry_t& second){
+            return compare_paths(get_path(first), get_path(second)) == 0;
+        }
+    );
+    m_entries.erase(m_entries.begin(), replaced.begin().base());
+}
+
+void sorted_collector::spill()
+{
+    if (m_entries.empty()){
+        return;
+    }
+    sort_entries();
+    auto run = make_run_path();
+    try {
+        run_writer writer{run};
+        for (const auto& entry : m_entries){
+            writer.write(
+                get_path(entry), {m_bytes.data() + entry.offset + entry.path_size, entry.type_size},
+                entry.error, entry.size
+            );
+        }
+        writer.close();
+        m_runs.push_back(run);
+    } catch (...){
+        std::error_code error_code;
+        std::filesystem::remove(run, error_code);
+        throw;
+    }
+    m_bytes.clear();
+    m_entries.clear();
+}
+
+void sorted_collector::merge_runs()
+{
+    std::vector<std::filesystem::path> runs;
+    for (std::size_t first{}; first < m_runs.size(); first += merge_width){
+        const std::span group{m_runs.begin() + first, std::min(merge_width, m_runs.size() - first)};
+        auto run = make_run_path();
+        try {
+            run_writer writer{run};
+            merge(group,
+                [&](const run_record& current){
+                    writer.write(current.path, current.type, current.error, current.size);
+                }
+            );
+            writer.close();
+        } catch (...){
+            runs.push_back(std::move(run));
+            for (const auto& merged_run : runs){
+                std::error_code error_code;
+                std::filesystem::remove(merged_run, error_code);
+            }
+            throw;
+        }
+        runs.push_back(std::move(run));
+    }
+    for (const auto& run : m_runs){
+        std::error_code error_code;
+        std::filesystem::remove(run, error_code);
+    }
+    m_runs = std::move(runs);
+}
+
+std::filesystem::path sorted_collector::make_run_path()
+{
+    return m_temporary_directory / std::format("magicxx-{}-{}-{}.run", ::getpid(), m_collector_id, m_next_run++);
+}
+
+} /* namespace recognition::results */
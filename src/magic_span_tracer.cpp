@@ -0,0 +1,81 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <string>
+#include <utility>
+#include <unistd.h>
+
+#include <magic_exception.hpp>
+#include <magic_span_tracer.hpp>
+
+#include "json_string.hpp"
+
+namespace recognition::trace {
+
+chrome_trace_writer::chrome_trace_writer(const std::filesystem::path& trace_file)
+    : m_trace_file{trace_file},
+      m_start{clock_t::now()},
+      m_stream{trace_file, std::ios::trunc}
+{
+    m_stream << "[\n";
+    if (!m_stream.flush()){
+        throw magic_trace_error{"failed to create the trace file", trace_file.string()};
+    }
+}
+
+chrome_trace_writer::~chrome_trace_writer()
+{
+    m_stream << "\n]\n";
+}
+
+void chrome_trace_writer::begin(std::string_view name, std::string_view detail, clock_t::time_point time) noexcept
+{
+    write_event(name, 'B', detail, time);
+}
+
+void chrome_trace_writer::end(std::string_view name, clock_t::time_point time) noexcept
+{
+    write_event(name, 'E', {}, time);
+}
+
+const std::filesystem::path& chrome_trace_writer::file() const noexcept
+{
+    return m_trace_file;
+}
+
+void chrome_trace_writer::flush() noexcept
+{
+    std::scoped_lock lock{m_mutex};
+    m_stream.flush();
+}
+
+void chrome_trace_writer::write_event(
+    std::string_view name, char phase,
+    std::string_view detail, clock_t::time_point time) noexcept
+{
+    try {
+        static const auto process_id = ::getpid();
+        thread_local const auto thread_id = ::gettid();
+        const std::chrono::duration<double, std::micro> timestamp{time - m_start};
+        std::string event{"{\"name\":\""};
+        json::append_string(event, name);
+        event += std::format(R"(","cat":"magicxx","ph":"{}","ts":{:.3f},"pid":{},"tid":{})",
+            phase, timestamp.count(), process_id, thread_id
+        );
+        if (!detail.empty()){
+            event += ",\"args\":{\"detail\":\"";
+            json::append_string(event, detail);
+            event += "\"}";
+        }
+        event += '}';
+        std::scoped_lock lock{m_mutex};
+        if (!std::exchange(m_first_event, false)){
+            m_stream << ",\n";
+        }
+        m_stream << event;
+    } catch (...){
+    }
+}
+
+} /* namespace recognition::trace */
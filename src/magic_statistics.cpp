@@ -0,0 +1,276 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <bit>
+#include <cmath>
+#include <format>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <magic_statistics.hpp>
+
+namespace recognition {
+
+namespace {
+
+/**
+ * @brief Appends a string to an OpenMetrics label value, escaping the quotes,
+ *        the backslashes and the line feeds.
+ */
+void append_label_value(std::string& metrics, std::string_view value)
+{
+    for (auto character : value){
+        switch (character){
+        case '"':  metrics += "\\\""; break;
+        case '\\': metrics += "\\\\"; break;
+        case '\n': metrics += "\\n";  break;
+        default:   metrics += character;
+        }
+    }
+}
+
+[[nodiscard]]
+double to_seconds(std::chrono::nanoseconds duration) noexcept
+{
+    return std::chrono::duration<double>{duration}.count();
+}
+
+} /* namespace */
+
+latency_histogram::latency_histogram(
+    const counts_t& counts, std::chrono::nanoseconds total,
+    std::chrono::nanoseconds min, std::chrono::nanoseconds max) noexcept
+    : m_counts{counts},
+      m_total{total},
+      m_min{min},
+      m_max{max}
+{
+    for (auto count : m_counts){
+        m_count += count;
+    }
+}
+
+std::span<const std::uint64_t, latency_histogram::bucket_count> latency_histogram::counts() const noexcept
+{
+    return m_counts;
+}
+
+std::uint64_t latency_histogram::count() const noexcept
+{
+    return m_count;
+}
+
+std::chrono::nanoseconds latency_histogram::max() const noexcept
+{
+    return m_max;
+}
+
+std::chrono::nanoseconds latency_histogram::mean() const noexcept
+{
+    if (m_count == 0){
+        return {};
+    }
+    return m_total / static_cast<std::chrono::nanoseconds::rep>(m_count);
+}
+
+void latency_histogram::merge(const latency_histogram& other) noexcept
+{
+    if (other.m_count == 0){
+        return;
+    }
+    for (std::size_t i{}; i < bucket_count; ++i){
+        m_counts[i] += other.m_counts[i];
+    }
+    m_min = m_count == 0 ? other.m_min : std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_count += other.m_count;
+    m_total += other.m_total;
+}
+
+std::chrono::nanoseconds latency_histogram::min() const noexcept
+{
+    return m_min;
+}
+
+std::chrono::nanoseconds latency_histogram::percentile(double percentile) const noexcept
+{
+    if (m_count == 0){
+        return {};
+    }
+    const auto rank = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(m_count))),
+        1
+    );
+    std::uint64_t cumulative_count{};
+    for (std::size_t i{}; i < bucket_count; ++i){
+        cumulative_count += m_counts[i];
+        if (cumulative_count >= rank){
+            return std::clamp(
+                std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(highest_value_of(i))},
+                m_min, m_max
+            );
+        }
+    }
+    return m_max;
+}
+
+void latency_histogram::record(std::chrono::nanoseconds latency) noexcept
+{
+    latency = std::max(latency, std::chrono::nanoseconds{});
+    ++m_counts[index_of(static_cast<std::uint64_t>(latency.count()))];
+    m_min = m_count == 0 ? latency : std::min(m_min, latency);
+    m_max = std::max(m_max, latency);
+    ++m_count;
+    m_total += latency;
+}
+
+std::chrono::nanoseconds latency_histogram::total() const noexcept
+{
+    return m_total;
+}
+
+std::uint64_t latency_histogram::highest_value_of(std::size_t index) noexcept
+{
+    if (index + 1 >= bucket_count){
+        return (1ULL << max_value_bits) - 1;
+    }
+    return lowest_value_of(index + 1) - 1;
+}
+
+std::size_t latency_histogram::index_of(std::uint64_t value) noexcept
+{
+    if (value < sub_bucket_count){
+        return static_cast<std::size_t>(value);
+    }
+    const auto most_significant_bit = static_cast<std::size_t>(std::bit_width(value)) - 1;
+    if (most_significant_bit >= max_value_bits){
+        return bucket_count - 1;
+    }
+    const auto shift = most_significant_bit - sub_bucket_bits;
+    return (shift + 1) * sub_bucket_count + static_cast<std::size_t>((value >> shift) & (sub_bucket_count - 1));
+}
+
+std::uint64_t latency_histogram::lowest_value_of(std::size_t index) noexcept
+{
+    if (index < sub_bucket_count){
+        return index;
+    }
+    const auto shift = index / sub_bucket_count - 1;
+    return (sub_bucket_count + index % sub_bucket_count) << shift;
+}
+
+std::string to_string(identification_stage stage)
+{
+    static constexpr std::array<const char*, identification_stage_count> stage_names{
+        "traversal", "stat", "open", "classify", "conversion"
+    };
+    return stage_names[std::to_underlying(stage)];
+}
+
+std::string to_string(identification_error error)
+{
+    static constexpr std::array<const char*, identification_error_count> error_names{
+        "magic_is_closed", "empty_path", "magic_file_error"
+    };
+    return error_names[std::to_underlying(error)];
+}
+
+std::string to_openmetrics(const magic_statistics& statistics, std::string_view prefix)
+{
+    std::string metrics;
+    auto add_family = [&](std::string_view name, std::string_view type, std::string_view help){
+        metrics += std::format("# TYPE {}_{} {}\n# HELP {}_{} {}\n", prefix, name, type, prefix, name, help);
+    };
+    auto add_sample = [&](std::string_view name, std::string_view label, std::string_view label_value, auto value){
+        metrics += std::format("{}_{}", prefix, name);
+        if (!label.empty()){
+            metrics += std::format("{{{}=\"", label);
+            append_label_value(metrics, label_value);
+            metrics += "\"}";
+        }
+        metrics += std::format(" {}\n", value);
+    };
+    add_family("identifications", "counter", "The number of the identifications.");
+    add_sample("identifications_total", {}, {}, statistics.calls);
+    add_family("identification_errors", "counter", "The number of the failed identifications by the type of the error.");
+    for (std::size_t i{}; i < identification_error_count; ++i){
+        add_sample("identification_errors_total", "type",
+            to_string(static_cast<identification_error>(i)), statistics.errors_by_type[i]
+        );
+    }
+    add_family("identified_bytes", "counter", "The total size of the identified regular files.");
+    add_sample("identified_bytes_total", {}, {}, statistics.bytes);
+    add_family("dispatch_index_cache_lookups", "counter", "The number of the dispatch index sub database cache lookups.");
+    add_sample("dispatch_index_cache_lookups_total", "result", "hit", statistics.cache_hits);
+    add_sample("dispatch_index_cache_lookups_total", "result", "miss", statistics.cache_misses);
+    add_family("database_loads", "counter", "The number of the database files and buffers loaded.");
+    add_sample("database_loads_total", {}, {}, statistics.database_loads);
+    add_family("identification_latency_seconds", "histogram", "The latencies of the identifications.");
+    const auto counts = statistics.latency.counts();
+    std::uint64_t cumulative_count{};
+    for (std::size_t i{}; i + 1 < latency_histogram::bucket_count; ++i){
+        cumulative_count += counts[i];
+        if ((i + 1) % latency_histogram::sub_bucket_count == 0){
+            const auto upper_bound = static_cast<double>(latency_histogram::highest_value_of(i)) / 1e9;
+            add_sample("identification_latency_seconds_bucket", "le", std::format("{}", upper_bound), cumulative_count);
+        }
+    }
+    add_sample("identification_latency_seconds_bucket", "le", "+Inf", statistics.latency.count());
+    add_sample("identification_latency_seconds_count", {}, {}, statistics.latency.count());
+    add_sample("identification_latency_seconds_sum", {}, {}, to_seconds(statistics.latency.total()));
+    add_family("stage_timed_identifications", "counter", "The number of the identifications timed by stage.");
+    add_sample("stage_timed_identifications_total", {}, {}, statistics.timed_calls);
+    add_family("stage_duration_seconds", "counter", "The total durations of the stages of the timed identifications.");
+    for (std::size_t i{}; i < identification_stage_count; ++i){
+        add_sample("stage_duration_seconds_total", "stage",
+            to_string(static_cast<identification_stage>(i)), to_seconds(statistics.stage_durations[i])
+        );
+    }
+    if (!statistics.type_costs.empty()){
+        add_family("type_identifications", "counter", "The number of the identifications by the type of the files.");
+        for (const auto& [type, cost] : statistics.type_costs){
+            add_sample("type_identifications_total", "type", type, cost.calls);
+        }
+        add_family("type_identification_seconds", "counter", "The total latencies of the identifications by the type of the files.");
+        for (const auto& [type, cost] : statistics.type_costs){
+            add_sample("type_identification_seconds_total", "type", type, to_seconds(cost.latency));
+        }
+    }
+    metrics += "# EOF\n";
+    return metrics;
+}
+
+std::string to_string(const type_costs_t& type_costs)
+{
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    using microseconds = std::chrono::duration<double, std::micro>;
+    std::vector<const type_costs_t::value_type*> sorted_type_costs;
+    std::chrono::nanoseconds total_latency{};
+    for (const auto& type_cost_pair : type_costs){
+        sorted_type_costs.push_back(&type_cost_pair);
+        total_latency += type_cost_pair.second.latency;
+    }
+    std::ranges::sort(sorted_type_costs, std::ranges::greater{},
+        [](const auto* type_cost_pair){
+            return type_cost_pair->second.latency;
+        }
+    );
+    auto report = std::format("{:>7} {:>10} {:>14} {:>12} {:>10} {:>10}  {}\n",
+        "share", "calls", "bytes", "total_ms", "mean_us", "max_us", "type"
+    );
+    for (const auto* type_cost_pair : sorted_type_costs){
+        const auto& [type, cost] = *type_cost_pair;
+        const auto share = total_latency.count() == 0 ? 0.0 :
+            100.0 * static_cast<double>(cost.latency.count()) / static_cast<double>(total_latency.count());
+        const auto mean = cost.calls == 0 ? microseconds{} : microseconds{cost.latency} / static_cast<double>(cost.calls);
+        report += std::format("{:>6.2f}% {:>10} {:>14} {:>12.3f} {:>10.1f} {:>10.1f}  {}\n",
+            share, cost.calls, cost.bytes, milliseconds{cost.latency}.count(),
+            mean.count(), microseconds{cost.max_latency}.count(), type
+        );
+    }
+    return report;
+}
+
+} /* namespace recognition */
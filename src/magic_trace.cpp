@@ -0,0 +1,231 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <array>
+#include <utility>
+#include <iterator>
+#include <optional>
+
+#include <magic_trace.hpp>
+#include <magic_exception.hpp>
+
+#include "binary_encoding.hpp"
+
+namespace recognition::trace {
+
+namespace {
+
+void write_bytes(std::string& buffer, std::string_view bytes)
+{
+    binary::write_variable_integer(buffer, bytes.size());
+    buffer.append(bytes);
+}
+
+/**
+ * @brief The parser class reads the LEB128 encoded integers and the bytes of a trace file.
+ */
+class parser {
+public:
+    explicit parser(std::string_view contents) noexcept
+        : m_contents{contents}
+    { }
+
+    [[nodiscard]]
+    bool empty() const noexcept
+    {
+        return m_position == m_contents.size();
+    }
+
+    [[nodiscard]]
+    std::optional<std::string_view> read_bytes(std::size_t size) noexcept
+    {
+        if (m_contents.size() - m_position < size){
+            return std::nullopt;
+        }
+        auto bytes = m_contents.substr(m_position, size);
+        m_position += size;
+        return bytes;
+    }
+
+    [[nodiscard]]
+    std::optional<std::uint64_t> read_integer() noexcept
+    {
+        return binary::read_variable_integer(
+            [this]() noexcept {
+                return !empty() ? static_cast<std::uint8_t>(m_contents[m_position++]) : -1;
+            }
+        );
+    }
+
+    [[nodiscard]]
+    std::optional<std::uint64_t> read_fixed_integer() noexcept
+    {
+        auto bytes = read_bytes(sizeof(std::uint64_t));
+        if (!bytes){
+            return std::nullopt;
+        }
+        return binary::read_integer<std::uint64_t>(bytes->data());
+    }
+
+    [[nodiscard]]
+    std::optional<std::string_view> read_sized_bytes() noexcept
+    {
+        auto size = read_integer();
+        if (!size){
+            return std::nullopt;
+        }
+        return read_bytes(*size);
+    }
+
+private:
+    std::string_view m_contents;
+    std::size_t m_position{};
+};
+
+[[nodiscard]]
+std::optional<record> read_record(parser& trace_parser)
+{
+    auto header = trace_parser.read_bytes(2);
+    auto flags_mask = trace_parser.read_integer();
+    auto offset = trace_parser.read_integer();
+    auto duration = trace_parser.read_integer();
+    auto input_hash = trace_parser.read_fixed_integer();
+    auto path = trace_parser.read_sized_bytes();
+    auto prefix = trace_parser.read_sized_bytes();
+    if (!header || !flags_mask || !offset || !duration || !input_hash || !path || !prefix){
+        return std::nullopt;
+    }
+    const auto kind = static_cast<std::uint8_t>((*header)[0]);
+    if (kind > std::to_underlying(call::load_database_buffer)){
+        return std::nullopt;
+    }
+    return record{
+        .kind = static_cast<call>(kind),
+        .succeeded = (*header)[1] != 0,
+        .flags_mask = *flags_mask,
+        .offset = std::chrono::nanoseconds{*offset},
+        .duration = std::chrono::nanoseconds{*duration},
+        .path = std::filesystem::path{std::string{*path}},
+        .input_hash = *input_hash,
+        .prefix = std::string{*prefix}
+    };
+}
+
+} /* namespace */
+
+writer::writer(const std::filesystem::path& trace_file, std::size_t prefix_size)
+    : m_file{trace_file},
+      m_prefix_size{prefix_size},
+      m_start{clock_t::now()},
+      m_stream{trace_file, std::ios::binary | std::ios::trunc}
+{
+    m_stream << signature << static_cast<char>(version);
+    if (!m_stream.flush()){
+        throw magic_trace_error{"failed to create the trace file", trace_file.string()};
+    }
+}
+
+const std::filesystem::path& writer::file() const noexcept
+{
+    return m_file;
+}
+
+std::size_t writer::prefix_size() const noexcept
+{
+    return m_prefix_size;
+}
+
+writer::clock_t::time_point writer::start() const noexcept
+{
+    return m_start;
+}
+
+void writer::write(const record& trace_record) noexcept
+{
+    try {
+        std::string buffer;
+        buffer.push_back(static_cast<char>(std::to_underlying(trace_record.kind)));
+        buffer.push_back(static_cast<char>(trace_record.succeeded));
+        binary::write_variable_integer(buffer, trace_record.flags_mask);
+        binary::write_variable_integer(buffer, static_cast<std::uint64_t>(trace_record.offset.count()));
+        binary::write_variable_integer(buffer, static_cast<std::uint64_t>(trace_record.duration.count()));
+        binary::write_integer(buffer, trace_record.input_hash);
+        write_bytes(buffer, trace_record.path.native());
+        write_bytes(buffer, trace_record.prefix);
+        m_stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    } catch (...){
+    }
+}
+
+void writer::write_file_record(
+    call kind, bool succeeded, std::uint64_t flags_mask,
+    clock_t::time_point call_start, clock_t::time_point call_end,
+    const std::filesystem::path& path) noexcept
+{
+    try {
+        std::string prefix;
+        if (m_prefix_size != 0 && (kind == call::identify_file || kind == call::identify_file_nothrow)){
+            prefix.resize(m_prefix_size);
+            std::ifstream file{path, std::ios::binary};
+            file.read(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+            prefix.resize(static_cast<std::size_t>(file.gcount()));
+        }
+        write(record{
+            .kind = kind,
+            .succeeded = succeeded,
+            .flags_mask = flags_mask,
+            .offset = std::chrono::duration_cast<std::chrono::nanoseconds>(call_start - m_start),
+            .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(call_end - call_start),
+            .path = path,
+            .input_hash = prefix.empty() ? 0 : hash(prefix),
+            .prefix = std::move(prefix)
+        });
+    } catch (...){
+    }
+}
+
+std::uint64_t hash(std::string_view bytes) noexcept
+{
+    return binary::hash(bytes);
+}
+
+std::vector<record> read(const std::filesystem::path& trace_file)
+{
+    std::ifstream file{trace_file, std::ios::binary};
+    if (!file){
+        throw magic_trace_error{"failed to open the trace file", trace_file.string()};
+    }
+    const std::string contents{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    parser trace_parser{contents};
+    auto header = trace_parser.read_bytes(signature.size() + 1);
+    if (!header || header->substr(0, signature.size()) != signature){
+        throw magic_trace_error{"invalid signature", trace_file.string()};
+    }
+    if (static_cast<std::uint8_t>(header->back()) != version){
+        throw magic_trace_error{"unsupported version", trace_file.string()};
+    }
+    std::vector<record> records;
+    while (!trace_parser.empty()){
+        auto trace_record = read_record(trace_parser);
+        if (!trace_record){
+            throw magic_trace_error{
+                "malformed record " + std::to_string(records.size()), trace_file.string()
+            };
+        }
+        records.push_back(std::move(*trace_record));
+    }
+    return records;
+}
+
+std::string to_string(call kind)
+{
+    static constexpr std::array call_names{
+        "identify_file",
+        "identify_file_nothrow",
+        "load_database_file",
+        "load_database_buffer"
+    };
+    return call_names[std::to_underlying(kind)];
+}
+
+} /* namespace recognition::trace */
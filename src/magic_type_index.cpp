@@ -0,0 +1,291 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+#include <magic_exception.hpp>
+#include <magic_type_index.hpp>
+
+#include "mapped_file.hpp"
+#include "binary_encoding.hpp"
+
+namespace recognition::results {
+
+using namespace binary;
+
+namespace {
+
+/**
+ * @brief The size of the header, the signature followed by the version and the number of the types.
+ */
+constexpr std::size_t header_size{type_index_signature.size() + 1 + sizeof(std::uint32_t)};
+
+/**
+ * @brief The size of an entry of the directory, the offset and the size of the type,
+ *        the offset and the size of its posting list, and the number of its paths.
+ */
+constexpr std::size_t directory_entry_size{2 * sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t)};
+
+/**
+ * @brief The entry of the directory of a type index file.
+ */
+struct directory_entry {
+    std::uint32_t type_offset;
+    std::uint32_t type_size;
+    std::uint64_t postings_offset;
+    std::uint64_t postings_size;
+    std::uint64_t count;
+};
+
+[[nodiscard]]
+directory_entry read_directory_entry(const char* directory, std::size_t position) noexcept
+{
+    const auto entry = directory + position * directory_entry_size;
+    return {
+        read_integer<std::uint32_t>(entry),
+        read_integer<std::uint32_t>(entry, 1),
+        read_integer<std::uint64_t>(entry + 2 * sizeof(std::uint32_t)),
+        read_integer<std::uint64_t>(entry + 2 * sizeof(std::uint32_t), 1),
+        read_integer<std::uint64_t>(entry + 2 * sizeof(std::uint32_t), 2)
+    };
+}
+
+} /* namespace */
+
+type_index::type_index(const std::filesystem::path& index_file)
+{
+    try {
+        const auto contents = map_file(index_file);
+        m_data = contents.data();
+        m_size = contents.size();
+    } catch (const std::system_error& error){
+        throw magic_results_error{error.code().message(), index_file.string()};
+    }
+    try {
+        parse(index_file);
+    } catch (...){
+        unmap_file({m_data, m_size});
+        throw;
+    }
+}
+
+type_index::type_index(type_index&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_type_count{std::exchange(other.m_type_count, 0)},
+      m_directory{std::exchange(other.m_directory, nullptr)},
+      m_types{std::exchange(other.m_types, nullptr)},
+      m_postings{std::exchange(other.m_postings, nullptr)}
+{ }
+
+type_index& type_index::operator=(type_index&& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_type_count, other.m_type_count);
+    std::swap(m_directory, other.m_directory);
+    std::swap(m_types, other.m_types);
+    std::swap(m_postings, other.m_postings);
+    return *this;
+}
+
+type_index::~type_index()
+{
+    unmap_file({m_data, m_size});
+}
+
+std::size_t type_index::count(std::string_view type) const noexcept
+{
+    const auto position = find_position(type);
+    return position ? read_directory_entry(m_directory, *position).count : 0;
+}
+
+std::vector<std::uint64_t> type_index::find(std::string_view type) const
+{
+    const auto position = find_position(type);
+    if (!position){
+        return {};
+    }
+    const auto entry = read_directory_entry(m_directory, *position);
+    std::vector<std::uint64_t> path_ids;
+    path_ids.reserve(entry.count);
+    auto postings = m_postings + entry.postings_offset;
+    const auto postings_end = postings + entry.postings_size;
+    std::uint64_t path_id{};
+    for (std::uint64_t i{}; i < entry.count && postings != postings_end; ++i){
+        path_id += read_variable_integer(postings, postings_end);
+        path_ids.push_back(path_id);
+    }
+    return path_ids;
+}
+
+std::vector<std::string_view> type_index::types() const
+{
+    std::vector<std::string_view> types;
+    types.reserve(m_type_count);
+    for (std::size_t position{}; position < m_type_count; ++position){
+        types.push_back(get_type(position));
+    }
+    return types;
+}
+
+void type_index::parse(const std::filesystem::path& index_file)
+{
+    try {
+        cursor header{m_data, m_size, 0};
+        if (std::string_view{header.skip(type_index_signature.size()), type_index_signature.size()} != type_index_signature
+            || header.read<std::uint8_t>() != version){
+            throw std::out_of_range{"signature"};
+        }
+        m_type_count = header.read<std::uint32_t>();
+        m_directory = header.skip(m_type_count * directory_entry_size);
+        std::uint64_t types_size{};
+        std::uint64_t postings_size{};
+        for (std::size_t position{}; position < m_type_count; ++position){
+            const auto entry = read_directory_entry(m_directory, position);
+            if (entry.type_offset != types_size || entry.postings_offset != postings_size){
+                throw std::out_of_range{"directory"};
+            }
+            types_size += entry.type_size;
+            postings_size += entry.postings_size;
+        }
+        m_types = header.skip(types_size);
+        m_postings = header.skip(postings_size);
+        for (std::size_t position{1}; position < m_type_count; ++position){
+            if (get_type(position - 1) >= get_type(position)){
+                throw std::out_of_range{"types"};
+            }
+        }
+    } catch (const std::out_of_range&){
+        throw magic_results_error{"malformed type index file", index_file.string()};
+    }
+}
+
+std::string_view type_index::get_type(std::size_t position) const noexcept
+{
+    const auto entry = read_directory_entry(m_directory, position);
+    return {m_types + entry.type_offset, entry.type_size};
+}
+
+std::optional<std::size_t> type_index::find_position(std::string_view type) const noexcept
+{
+    std::size_t first{};
+    std::size_t last{m_type_count};
+    while (first < last){
+        const auto middle = first + (last - first) / 2;
+        const auto middle_type = get_type(middle);
+        if (middle_type == type){
+            return middle;
+        }
+        if (middle_type < type){
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return std::nullopt;
+}
+
+type_index_builder::type_index_builder(const type_index& index)
+{
+    for (auto type : index.types()){
+        m_path_ids.emplace(type, index.find(type));
+    }
+}
+
+void type_index_builder::add(std::uint64_t path_id, std::string_view type)
+{
+    auto path_ids = m_path_ids.find(type);
+    if (path_ids == m_path_ids.end()){
+        path_ids = m_path_ids.emplace(type, std::vector<std::uint64_t>{}).first;
+    }
+    path_ids->second.push_back(path_id);
+}
+
+void type_index_builder::add(const reader& results)
+{
+    results.for_each_type(
+        [this](std::size_t index, std::string_view type){
+            add(index, type);
+        }
+    );
+}
+
+void type_index_builder::apply(const std::vector<change>& changes)
+{
+    std::vector<std::uint64_t> changed_path_ids;
+    changed_path_ids.reserve(changes.size());
+    for (const auto& path_change : changes){
+        changed_path_ids.push_back(path_change.path_id);
+    }
+    std::ranges::sort(changed_path_ids);
+    for (auto& [type, path_ids] : m_path_ids){
+        std::erase_if(path_ids,
+            [&](std::uint64_t path_id){
+                return std::ranges::binary_search(changed_path_ids, path_id);
+            }
+        );
+    }
+    for (const auto& path_change : changes){
+        if (path_change.type){
+            add(path_change.path_id, *path_change.type);
+        }
+    }
+    std::erase_if(m_path_ids,
+        [](const auto& type_with_path_ids){
+            return type_with_path_ids.second.empty();
+        }
+    );
+}
+
+void type_index_builder::save(const std::filesystem::path& index_file)
+{
+    sort_path_ids();
+    std::string header{type_index_signature};
+    write_integer(header, version);
+    write_integer(header, static_cast<std::uint32_t>(m_path_ids.size()));
+    std::string types;
+    std::string postings;
+    for (const auto& [type, path_ids] : m_path_ids){
+        const auto postings_offset = postings.size();
+        std::uint64_t previous_path_id{};
+        for (auto path_id : path_ids){
+            write_variable_integer(postings, path_id - previous_path_id);
+            previous_path_id = path_id;
+        }
+        write_integer(header, static_cast<std::uint32_t>(types.size()));
+        write_integer(header, static_cast<std::uint32_t>(type.size()));
+        write_integer(header, static_cast<std::uint64_t>(postings_offset));
+        write_integer(header, static_cast<std::uint64_t>(postings.size() - postings_offset));
+        write_integer(header, static_cast<std::uint64_t>(path_ids.size()));
+        types += type;
+    }
+    auto temporary_file = index_file;
+    temporary_file += ".tmp";
+    std::ofstream file{temporary_file, std::ios::binary | std::ios::trunc};
+    file << header << types << postings;
+    file.close();
+    std::error_code error;
+    if (file){
+        std::filesystem::rename(temporary_file, index_file, error);
+    }
+    if (!file || error){
+        std::filesystem::remove(temporary_file, error);
+        throw magic_results_error{"failed to write the type index file", index_file.string()};
+    }
+}
+
+void type_index_builder::sort_path_ids()
+{
+    for (auto& [type, path_ids] : m_path_ids){
+        std::ranges::sort(path_ids);
+        const auto duplicates = std::ranges::unique(path_ids);
+        path_ids.erase(duplicates.begin(), duplicates.end());
+    }
+}
+
+} /* namespace recognition::results */
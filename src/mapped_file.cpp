@@ -0,0 +1,48 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+
+#include "mapped_file.hpp"
+
+namespace recognition {
+
+std::string_view map_file(const std::filesystem::path& file)
+{
+    const auto file_descriptor = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor < 0){
+        throw std::system_error{errno, std::generic_category()};
+    }
+    struct stat file_status{};
+    if (::fstat(file_descriptor, &file_status) != 0){
+        const auto error_number = errno;
+        ::close(file_descriptor);
+        throw std::system_error{error_number, std::generic_category()};
+    }
+    const auto size = static_cast<std::size_t>(file_status.st_size);
+    if (size == 0){
+        ::close(file_descriptor);
+        return {};
+    }
+    const auto data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    const auto error_number = errno;
+    ::close(file_descriptor);
+    if (data == MAP_FAILED){
+        throw std::system_error{error_number, std::generic_category()};
+    }
+    return {static_cast<const char*>(data), size};
+}
+
+void unmap_file(std::string_view contents) noexcept
+{
+    if (!contents.empty()){
+        ::munmap(const_cast<char*>(contents.data()), contents.size());
+    }
+}
+
+} /* namespace recognition */
@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <filesystem>
+#include <string_view>
+
+namespace recognition {
+
+/**
+ * @brief Map a file into memory read only.
+ *
+ * @param[in] file              The path of the file.
+ *
+ * @returns The contents of the file, empty if the file is empty.
+ *
+ * @throws std::system_error    if the file can not be opened or mapped.
+ */
+[[nodiscard]]
+std::string_view map_file(const std::filesystem::path& file);
+
+/**
+ * @brief Unmap the contents of a file mapped by map_file().
+ */
+void unmap_file(std::string_view contents) noexcept;
+
+} /* namespace recognition */
+
+#endif /* MAPPED_FILE_HPP */
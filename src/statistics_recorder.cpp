@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <utility>
+#include <algorithm>
+
+#include "statistics_recorder.hpp"
+
+namespace recognition {
+
+void statistics_recorder::record_call(std::chrono::nanoseconds latency, bool succeeded, std::uint64_t bytes) noexcept
+{
+    ++m_statistics.calls;
+    m_statistics.errors += succeeded ? 0 : 1;
+    m_statistics.bytes += bytes;
+    m_statistics.latency.record(latency);
+}
+
+void statistics_recorder::record_database_load() noexcept
+{
+    ++m_statistics.database_loads;
+}
+
+void statistics_recorder::record_error(identification_error error) noexcept
+{
+    ++m_statistics.errors_by_type[std::to_underlying(error)];
+}
+
+void statistics_recorder::record_cache_lookup(bool hit) noexcept
+{
+    ++(hit ? m_statistics.cache_hits : m_statistics.cache_misses);
+}
+
+void statistics_recorder::record_stages(const stage_durations_t& stage_durations) noexcept
+{
+    ++m_statistics.timed_calls;
+    for (std::size_t i{}; i < identification_stage_count; ++i){
+        m_statistics.stage_durations[i] += std::max(stage_durations[i], std::chrono::nanoseconds{});
+    }
+}
+
+void statistics_recorder::record_type(std::string_view type, std::chrono::nanoseconds latency, std::uint64_t bytes) noexcept
+{
+    try {
+        auto& type_costs = m_statistics.type_costs;
+        auto type_cost_pair = type_costs.find(type);
+        if (type_cost_pair == type_costs.end()){
+            type_cost_pair = type_costs.emplace(type_costs.size() < max_type_count ? type : other_type, type_cost{}).first;
+        }
+        auto& cost = type_cost_pair->second;
+        ++cost.calls;
+        cost.bytes += bytes;
+        cost.latency += latency;
+        cost.max_latency = std::max(cost.max_latency, latency);
+    } catch (...){
+    }
+}
+
+void statistics_recorder::reset() noexcept
+{
+    m_statistics = magic_statistics{};
+}
+
+magic_statistics statistics_recorder::snapshot() const noexcept
+{
+    magic_statistics statistics;
+    try {
+        statistics = m_statistics;
+    } catch (...){
+        statistics.type_costs.clear();
+    }
+    return statistics;
+}
+
+} /* namespace recognition */
@@ -0,0 +1,90 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef STATISTICS_RECORDER_HPP
+#define STATISTICS_RECORDER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include <magic_statistics.hpp>
+
+namespace recognition {
+
+/**
+ * @class statistics_recorder
+ *
+ * @brief The statistics_recorder class records the statistics of the identifications of a magic.
+ *
+ * @note A magic is used by one thread at a time, so the statistics are plain counters
+ *       recorded by that thread, and a snapshot is a copy of them.
+ */
+class statistics_recorder {
+public:
+
+    /**
+     * @brief Record an identification.
+     *
+     * @param[in] latency           The duration of the identification.
+     * @param[in] succeeded         True if the identification succeeded.
+     * @param[in] bytes             The size of the identified file.
+     */
+    void record_call(std::chrono::nanoseconds latency, bool succeeded, std::uint64_t bytes) noexcept;
+
+    /**
+     * @brief Record a loaded database file or buffer.
+     */
+    void record_database_load() noexcept;
+
+    /**
+     * @brief Record the type of the error of a failed identification.
+     */
+    void record_error(identification_error error) noexcept;
+
+    /**
+     * @brief Record a lookup of the dispatch index sub database cache.
+     */
+    void record_cache_lookup(bool hit) noexcept;
+
+    /**
+     * @brief Record the durations of the stages of a timed identification.
+     */
+    void record_stages(const stage_durations_t& stage_durations) noexcept;
+
+    /**
+     * @brief Record a succeeded identification by the type of the file.
+     *
+     * @param[in] type              The type of the file.
+     * @param[in] latency           The duration of the identification.
+     * @param[in] bytes             The size of the identified file.
+     *
+     * @note The identifications of more than max_type_count types are recorded as other_type.
+     */
+    void record_type(std::string_view type, std::chrono::nanoseconds latency, std::uint64_t bytes) noexcept;
+
+    /**
+     * @brief Zero the statistics.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Copy the statistics into a snapshot.
+     *
+     * @note The costs by type are the last member of magic_statistics, so they are the only
+     *       member whose copy can fail, and they are left empty if it fails.
+     */
+    [[nodiscard]]
+    magic_statistics snapshot() const noexcept;
+
+    static constexpr std::size_t max_type_count = 1024;
+
+    static constexpr std::string_view other_type = "other";
+
+private:
+    magic_statistics m_statistics;
+};
+
+} /* namespace recognition */
+
+#endif /* STATISTICS_RECORDER_HPP */
@@ -0,0 +1,77 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <fstream>
+#include <algorithm>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/compile_cache"};
+const std::filesystem::path cache_directory{test_directory / "cache"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+[[nodiscard]]
+std::size_t cached_database_files()
+{
+    return static_cast<std::size_t>(std::ranges::count_if(
+        std::filesystem::directory_iterator{cache_directory},
+        [](const auto& entry){
+            return entry.path().extension() == ".mgc";
+        }
+    ));
+}
+
+} /* namespace */
+
+TEST(magic_compile_cache_test, magic_set_compile_cache_directory)
+{
+    magic m;
+    EXPECT_TRUE(m.get_compile_cache_directory().empty());
+    m.set_compile_cache_directory(cache_directory);
+    EXPECT_EQ(m.get_compile_cache_directory(), cache_directory);
+    m.set_compile_cache_directory({});
+    EXPECT_TRUE(m.get_compile_cache_directory().empty());
+}
+
+TEST(magic_compile_cache_test, opened_magic_load_database_file_with_compile_cache)
+{
+    test::create_test_files(test_directory, "magicxx test");
+    magic m{magic::flags::none};
+    m.set_compile_cache_directory(cache_directory);
+    m.load_database_file(test_database);
+    EXPECT_EQ(m.identify_file(test_file), "magicxx test");
+    EXPECT_EQ(cached_database_files(), 1);
+    m.load_database_file(test_database);
+    EXPECT_EQ(m.identify_file(test_file), "magicxx test");
+    EXPECT_EQ(cached_database_files(), 1);
+    std::ofstream database{test_database, std::ios::trunc};
+    database << "0\tstring\tMAGICXX\tmagicxx changed test\n";
+    database.close();
+    m.load_database_file(test_database);
+    EXPECT_EQ(m.identify_file(test_file), "magicxx changed test");
+    EXPECT_EQ(cached_database_files(), 2);
+}
+
+TEST(magic_compile_cache_test, opened_magic_compile_with_compile_cache)
+{
+    test::create_test_files(test_directory, "magicxx test");
+    magic m{magic::flags::none};
+    m.set_compile_cache_directory(cache_directory);
+    const auto compiled_database = std::filesystem::current_path() / "test_database.mgc";
+    EXPECT_TRUE(m.compile(test_database));
+    EXPECT_TRUE(std::filesystem::is_regular_file(compiled_database));
+    EXPECT_EQ(cached_database_files(), 1);
+    std::filesystem::remove(compiled_database);
+    EXPECT_TRUE(m.compile(test_database));
+    EXPECT_TRUE(std::filesystem::is_regular_file(compiled_database));
+    EXPECT_EQ(cached_database_files(), 1);
+    std::filesystem::remove(compiled_database);
+}
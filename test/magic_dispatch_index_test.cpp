@@ -0,0 +1,178 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <random>
+#include <string>
+#include <format>
+#include <fstream>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/dispatch_index"};
+
+void create_test_files()
+{
+    using namespace std::string_literals;
+    std::filesystem::create_directories(test_directory);
+    const std::map<std::string, std::string> test_files{
+        {"empty",     ""},
+        {"text",      "Lorem ipsum dolor sit amet.\n"},
+        {"script",    "#!/bin/sh\necho test\n"},
+        {"elf",       "\x7f" "ELF\x02\x01\x01\0\0\0\0\0\0\0\0\0\x02\0\x3e\0"s},
+        {"png",       "\x89PNG\r\n\x1a\n\0\0\0\rIHDR\0\0\0\x10\0\0\0\x10\x08\x06\0\0\0"s},
+        {"gzip",      "\x1f\x8b\x08\0\0\0\0\0\0\x03"s},
+        {"zip",       "PK\x03\x04\x14\0\0\0\x08\0"s},
+        {"pdf",       "%PDF-1.7\n%\xe2\xe3\xcf\xd3\n"},
+        {"jpeg",      "\xff\xd8\xff\xe0\0\x10JFIF\0\x01\x01\0\0\x01\0\x01\0\0"s},
+        {"id3",       "ID3\x03\0\0\0\0\0\0"s},
+        {"html",      "<!DOCTYPE html>\n<html><body></body></html>\n"},
+        {"json",      "{\"key\": [1, 2, 3]}\n"},
+        {"xml_utf8",  "\xef\xbb\xbf<?xml version=\"1.0\"?>\n<a/>\n"},
+        {"xml_utf16", "\xff\xfe<\0?\0x\0m\0l\0 \0v\0e\0r\0s\0i\0o\0n\0=\0\"\0" "1\0.\0" "0\0\"\0?\0>\0\n\0"s}
+    };
+    for (const auto& [name, content] : test_files){
+        std::ofstream file{test_directory / name, std::ios::binary | std::ios::trunc};
+        file << content;
+    }
+    std::mt19937 eng{42};
+    std::uniform_int_distribution<int> dist{0, 255};
+    std::ofstream file{test_directory / "random", std::ios::binary | std::ios::trunc};
+    for (std::size_t i{}; i < 8192; ++i){
+        file.put(static_cast<char>(dist(eng)));
+    }
+}
+
+/**
+ * @brief Recreate a directory holding a text database with the lines and the files with the contents.
+ */
+void create_test_files(
+    const std::filesystem::path& directory,
+    const std::vector<std::string>& database_lines,
+    const std::map<std::string, std::string>& files)
+{
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::ofstream database{directory / "test_database", std::ios::trunc};
+    for (const auto& line : database_lines){
+        database << line << '\n';
+    }
+    for (const auto& [name, content] : files){
+        std::ofstream file{directory / name, std::ios::binary | std::ios::trunc};
+        file << content;
+    }
+}
+
+} /* namespace */
+
+TEST(magic_dispatch_index_test, magic_enable_dispatch_index)
+{
+    magic m;
+    EXPECT_FALSE(m.is_dispatch_index_enabled());
+    m.enable_dispatch_index();
+    EXPECT_TRUE(m.is_dispatch_index_enabled());
+    m.enable_dispatch_index(false);
+    EXPECT_FALSE(m.is_dispatch_index_enabled());
+}
+
+TEST(magic_dispatch_index_test, closed_magic_identify_file_with_dispatch_index)
+{
+    magic m;
+    m.enable_dispatch_index();
+    EXPECT_THROW([[maybe_unused]] auto _ = m.identify_file(magic::default_database_file), magic_is_closed);
+}
+
+TEST(magic_dispatch_index_test, opened_magic_identify_files_with_dispatch_index)
+{
+    create_test_files();
+    for (auto flags : {magic::flags::none, magic::flags::mime, magic::flags::continue_search}){
+        magic m{flags};
+        auto expected_types_of_files = m.identify_files(test_directory);
+        m.enable_dispatch_index();
+        EXPECT_EQ(m.identify_files(test_directory), expected_types_of_files);
+        EXPECT_EQ(m.identify_files(test_directory), expected_types_of_files);
+    }
+}
+
+TEST(magic_dispatch_index_test, opened_magic_set_flags_with_dispatch_index)
+{
+    create_test_files();
+    magic m{magic::flags::none};
+    m.enable_dispatch_index();
+    [[maybe_unused]] auto _ = m.identify_files(test_directory);
+    m.set_flags(magic::flags::mime_type);
+    auto types_of_files = m.identify_files(test_directory);
+    m.enable_dispatch_index(false);
+    EXPECT_EQ(m.identify_files(test_directory), types_of_files);
+}
+
+TEST(magic_dispatch_index_test, opened_magic_identify_file_with_indirect_and_use)
+{
+    const auto directory = test_directory / "indirect";
+    const auto files_directory = directory / "files";
+    create_test_files(directory, {
+        "0\tname\tmagicxx_part",
+        ">0\tstring\tPART\tmagicxx part",
+        "0\tstring\tOUTER\tmagicxx outer",
+        ">5\tindirect\tx",
+        "0\tstring\tINNER\tmagicxx inner",
+        "0\tstring\tUSED\tmagicxx used,",
+        ">4\tuse\tmagicxx_part"
+    }, {});
+    std::filesystem::create_directories(files_directory);
+    for (const auto& [name, content] : std::map<std::string, std::string>{
+        {"indirect", "OUTERINNER"}, {"inner", "INNER"}, {"use", "USEDPART"}
+    }){
+        std::ofstream file{files_directory / name, std::ios::trunc};
+        file << content;
+    }
+    magic m{magic::flags::none};
+    m.set_compile_cache_directory(directory / "cache");
+    m.load_database_file(directory / "test_database");
+    auto expected_types_of_files = m.identify_files(files_directory);
+    EXPECT_TRUE(expected_types_of_files[files_directory / "indirect"].ends_with("magicxx inner"));
+    EXPECT_EQ(expected_types_of_files[files_directory / "use"], "magicxx used, magicxx part");
+    m.enable_dispatch_index();
+#ifndef MAGICXX_DISABLE_STATISTICS
+    m.enable_statistics();
+#endif
+    EXPECT_EQ(m.identify_files(files_directory), expected_types_of_files);
+#ifndef MAGICXX_DISABLE_STATISTICS
+    const auto statistics = m.get_statistics();
+    EXPECT_EQ(statistics.cache_hits + statistics.cache_misses, 2);
+#endif
+}
+
+TEST(magic_dispatch_index_test, opened_magic_evict_least_recently_used_sub_database)
+{
+    constexpr auto sub_database_count = 17uz;
+    const auto directory = test_directory / "eviction";
+    std::vector<std::string> database_lines;
+    std::map<std::string, std::string> files;
+    for (std::size_t i{}; i < sub_database_count; ++i){
+        database_lines.push_back(std::format("0\tstring\tMAGICXX{:02}\tmagicxx test {}", i, i));
+        files.emplace(std::format("file_{:02}", i), std::format("MAGICXX{:02} test file\n", i));
+    }
+    create_test_files(directory, database_lines, files);
+    magic m{magic::flags::none};
+    m.set_compile_cache_directory(directory / "cache");
+    m.load_database_file(directory / "test_database");
+    m.enable_dispatch_index();
+#ifndef MAGICXX_DISABLE_STATISTICS
+    m.enable_statistics();
+#endif
+    for (std::size_t i{}; i < sub_database_count; ++i){
+        EXPECT_EQ(m.identify_file(directory / std::format("file_{:02}", i)), std::format("magicxx test {}", i));
+    }
+    EXPECT_EQ(m.identify_file(directory / "file_16"), "magicxx test 16");
+    EXPECT_EQ(m.identify_file(directory / "file_00"), "magicxx test 0");
+#ifndef MAGICXX_DISABLE_STATISTICS
+    const auto statistics = m.get_statistics();
+    EXPECT_EQ(statistics.cache_misses, sub_database_count + 1);
+    EXPECT_EQ(statistics.cache_hits, 1);
+#endif
+}
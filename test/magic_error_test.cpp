@@ -0,0 +1,78 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+
+using namespace recognition;
+
+TEST(magic_error_test, magic_error_code)
+{
+    std::error_code error_code = magic_errc::empty_path;
+    EXPECT_EQ(error_code, make_error_code(magic_errc::empty_path));
+    EXPECT_EQ(&error_code.category(), &magic_category());
+    EXPECT_STREQ(magic_category().name(), "magic");
+    EXPECT_EQ(error_code.message(), "path is empty.");
+    EXPECT_EQ(make_error_code(magic_errc::magic_is_closed).message(), "magic is closed.");
+}
+
+TEST(magic_error_test, magic_error_message)
+{
+    const magic_error error{magic_errc::magic_file_error, ENOENT};
+    EXPECT_EQ(error.code(), magic_errc::magic_file_error);
+    EXPECT_EQ(error.error_number(), ENOENT);
+    EXPECT_TRUE(error.description().empty());
+    EXPECT_EQ(error, (magic_error{magic_errc::magic_file_error, ENOENT}));
+    EXPECT_NE(error, magic_error{magic_errc::magic_file_error});
+    EXPECT_EQ(
+        error.message("/missing"),
+        magic_file_error(std::generic_category().message(ENOENT), "/missing").what()
+    );
+    EXPECT_EQ(magic_error{magic_errc::empty_path}.message("/missing"), "path is empty.");
+}
+
+TEST(magic_error_test, magic_error_description)
+{
+    const magic_error error{magic_errc::magic_file_error, ENOENT, "cannot open `/missing'"};
+    const auto copy = error;
+    EXPECT_EQ(copy.description(), "cannot open `/missing'");
+    EXPECT_EQ(copy, error);
+    EXPECT_NE(error, (magic_error{magic_errc::magic_file_error, ENOENT}));
+    EXPECT_EQ(error, (magic_error{magic_errc::magic_file_error, ENOENT, std::string{"cannot open `/missing'"}}));
+    EXPECT_EQ(error.message("/missing"), magic_file_error("cannot open `/missing'", "/missing").what());
+    EXPECT_EQ((magic_error{magic_errc::magic_file_error, ENOENT, ""}), (magic_error{magic_errc::magic_file_error, ENOENT}));
+}
+
+TEST(magic_error_test, magic_error_long_description)
+{
+    const std::string inline_description(magic_error::inline_description_capacity, 'x');
+    const std::string long_description(magic_error::inline_description_capacity + 1, 'x');
+    const magic_error inline_error{magic_errc::magic_file_error, ENOENT, inline_description};
+    const magic_error long_error{magic_errc::magic_file_error, ENOENT, long_description};
+    const auto copy = long_error;
+    EXPECT_EQ(inline_error.description(), inline_description);
+    EXPECT_EQ(long_error.description(), long_description);
+    EXPECT_EQ(copy.description().data(), long_error.description().data());
+    EXPECT_NE(inline_error, long_error);
+    EXPECT_EQ(long_error.message("/missing"), magic_file_error(long_description, "/missing").what());
+}
+
+TEST(magic_error_test, opened_magic_identify_missing_file)
+{
+    magic m{magic::flags::error};
+    const std::filesystem::path missing_file{"/tmp/magicxx_missing_file"};
+    auto expected_file_type = m.identify_file(missing_file, std::nothrow);
+    ASSERT_FALSE(expected_file_type.has_value());
+    EXPECT_EQ(expected_file_type.error().code(), magic_errc::magic_file_error);
+    EXPECT_EQ(expected_file_type.error().error_number(), ENOENT);
+    EXPECT_NE(to_string(expected_file_type, missing_file).find(missing_file.string()), std::string::npos);
+    EXPECT_NE(expected_file_type.error().description().find(missing_file.string()), std::string_view::npos);
+    try {
+        static_cast<void>(m.identify_file(missing_file));
+        FAIL();
+    } catch (const magic_file_error& error){
+        EXPECT_EQ(expected_file_type.error().message(missing_file), error.what());
+    }
+}
@@ -1,6 +1,8 @@
 /* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
 /* SPDX-License-Identifier: LGPL-3.0-only */
 
+#include <vector>
+
 #include <magic.hpp>
 #include <gtest/gtest.h>
 
@@ -11,7 +13,8 @@ TEST(magic_identify_file_test, closed_magic_identify_file)
     magic m;
     auto expected_file_type = m.identify_file(magic::default_database_file, std::nothrow);
     EXPECT_FALSE(expected_file_type.has_value());
-    EXPECT_EQ(expected_file_type.error(), "magic is closed.");
+    EXPECT_EQ(expected_file_type.error().code(), magic_errc::magic_is_closed);
+    EXPECT_EQ(expected_file_type.error().message(), "magic is closed.");
     EXPECT_THROW([[maybe_unused]] auto _ = m.identify_file(magic::default_database_file), magic_is_closed);
 }
 
@@ -20,7 +23,8 @@ TEST(magic_identify_file_test, opened_magic_identify_empty_path)
     magic m{magic::flags::mime};
     auto expected_file_type = m.identify_file({}, std::nothrow);
     EXPECT_FALSE(expected_file_type.has_value());
-    EXPECT_EQ(expected_file_type.error(), "path is empty.");
+    EXPECT_EQ(expected_file_type.error().code(), magic_errc::empty_path);
+    EXPECT_EQ(expected_file_type.error().message(), "path is empty.");
     EXPECT_THROW([[maybe_unused]] auto _ = m.identify_file({}), empty_path);
 }
 
@@ -30,3 +34,27 @@ TEST(magic_identify_file_test, opened_magic_identify_default_database)
     EXPECT_EQ(m.identify_file(magic::default_database_file), "text/x-file; charset=us-ascii");
     EXPECT_EQ(m.identify_file(magic::default_database_file, std::nothrow).value(), "text/x-file; charset=us-ascii");
 }
+
+TEST(magic_identify_file_test, opened_magic_identify_files_continue_on_error)
+{
+    magic m{magic::flags::error};
+    const std::filesystem::path missing_file{"/tmp/magicxx_missing_file"};
+    const std::vector<std::filesystem::path> files{
+        magic::default_database_file, missing_file, {}, "/tmp"
+    };
+    EXPECT_THROW([[maybe_unused]] auto _ = m.identify_files(files), magic_file_error);
+    const auto partial_types_of_files = m.identify_files(files, magic::continue_on_error);
+    const magic::types_of_files_t expected_types_of_files{
+        {magic::default_database_file, m.identify_file(magic::default_database_file)},
+        {"/tmp", m.identify_file("/tmp")}
+    };
+    EXPECT_EQ(partial_types_of_files.types_of_files, expected_types_of_files);
+    ASSERT_EQ(partial_types_of_files.errors.size(), 2);
+    EXPECT_EQ(partial_types_of_files.errors[0].index, 1);
+    EXPECT_EQ(partial_types_of_files.errors[0].error.code(), magic_errc::magic_file_error);
+    EXPECT_EQ(partial_types_of_files.errors[1], (magic::file_error{2, magic_error{magic_errc::empty_path}}));
+    m.close();
+    const auto closed_types_of_files = m.identify_files(files, magic::continue_on_error);
+    EXPECT_TRUE(closed_types_of_files.types_of_files.empty());
+    EXPECT_EQ(closed_types_of_files.errors.size(), files.size());
+}
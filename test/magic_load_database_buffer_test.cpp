@@ -0,0 +1,62 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <fstream>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+#include <magicxx_test_database.hpp>
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_file{"/tmp/test/database_buffer_test_file"};
+
+void create_test_file()
+{
+    std::filesystem::create_directories(test_file.parent_path());
+    std::ofstream file{test_file, std::ios::trunc};
+    file << "MAGICXX database buffer test\n";
+}
+
+} /* namespace */
+
+TEST(magic_load_database_buffer_test, closed_magic_load_database_buffer)
+{
+    magic m;
+    EXPECT_THROW(
+        m.load_database_buffer(databases::magicxx_test_database()),
+        magic_is_closed
+    );
+}
+
+TEST(magic_load_database_buffer_test, opened_magic_load_invalid_database_buffer)
+{
+    magic m{magic::flags::none};
+    const std::string invalid_database{"magicxx invalid database"};
+    EXPECT_THROW(
+        m.load_database_buffer(invalid_database),
+        magic_load_error
+    );
+}
+
+TEST(magic_load_database_buffer_test, opened_magic_load_embedded_database_buffer)
+{
+    create_test_file();
+    magic m{magic::flags::none};
+    m.load_database_buffer(databases::magicxx_test_database());
+    EXPECT_EQ(m.identify_file(test_file), "magicxx test database");
+    m.set_flags(magic::flags::mime_type);
+    EXPECT_EQ(m.identify_file(test_file), "application/x-magicxx-test");
+}
+
+TEST(magic_load_database_buffer_test, opened_magic_load_embedded_database_buffer_with_dispatch_index)
+{
+    create_test_file();
+    magic m{magic::flags::none};
+    m.enable_dispatch_index(true);
+    m.load_database_buffer(databases::magicxx_test_database());
+    EXPECT_TRUE(m.is_dispatch_index_enabled());
+    EXPECT_EQ(m.identify_file(test_file), "magicxx test database");
+}
@@ -0,0 +1,99 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <fstream>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+#include <magicxx_test_database.hpp>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/memory_usage"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+} /* namespace */
+
+TEST(magic_memory_usage_test, closed_magic_get_memory_usage)
+{
+    magic m;
+    EXPECT_EQ(m.get_memory_usage().total(), 0);
+}
+
+TEST(magic_memory_usage_test, opened_magic_get_memory_usage)
+{
+    test::create_test_files(test_directory, "magicxx memory usage test");
+    magic m{magic::flags::none, test_database};
+    auto memory_usage = m.get_memory_usage();
+    EXPECT_EQ(memory_usage.mapped_database, 0);
+    EXPECT_EQ(memory_usage.database_buffer, 0);
+    EXPECT_EQ(memory_usage.dispatch_index, 0);
+    ASSERT_TRUE(m.compile(test_database));
+    const auto compiled_database = std::filesystem::current_path() / "test_database.mgc";
+    m.load_database_file(compiled_database);
+    EXPECT_EQ(m.get_memory_usage().mapped_database, std::filesystem::file_size(compiled_database));
+    m.close();
+    EXPECT_EQ(m.get_memory_usage().total(), 0);
+}
+
+TEST(magic_memory_usage_test, opened_magic_get_memory_usage_of_dispatch_index)
+{
+    test::create_test_files(test_directory, "magicxx memory usage test");
+    const auto database_buffer = databases::magicxx_test_database();
+    magic m{magic::flags::none};
+    m.load_database_buffer(database_buffer);
+    auto memory_usage = m.get_memory_usage();
+    EXPECT_GE(memory_usage.database_buffer, database_buffer.size());
+    EXPECT_EQ(memory_usage.dispatch_index, 0);
+    m.enable_dispatch_index();
+    static_cast<void>(m.identify_file(test_file));
+    memory_usage = m.get_memory_usage();
+    EXPECT_GT(memory_usage.dispatch_index, database_buffer.size());
+    EXPECT_GT(memory_usage.indexed_databases, 0);
+    EXPECT_EQ(memory_usage.total(),
+        memory_usage.libmagic_heap + memory_usage.mapped_database + memory_usage.database_buffer +
+        memory_usage.dispatch_index + memory_usage.indexed_databases
+    );
+}
+
+#ifdef MAGICXX_COUNT_LIBMAGIC_HEAP
+
+TEST(magic_memory_usage_test, opened_magic_get_libmagic_heap)
+{
+    const auto larger_database = test_directory / "larger_database";
+    test::create_test_files(test_directory, "magicxx memory usage test");
+    std::ofstream database{larger_database, std::ios::trunc};
+    for (int i{}; i < 100; ++i){
+        database << "0\tstring\tMAGICXX" << i << "\tmagicxx memory usage test " << i << '\n';
+    }
+    database.close();
+    magic m;
+    m.open(magic::flags::none);
+    const auto cookie_heap = m.get_memory_usage().libmagic_heap;
+    EXPECT_GT(cookie_heap, 0);
+    m.load_database_file(test_database);
+    const auto libmagic_heap = m.get_memory_usage().libmagic_heap;
+    EXPECT_GT(libmagic_heap, cookie_heap);
+    m.load_database_file(larger_database);
+    EXPECT_GT(m.get_memory_usage().libmagic_heap, libmagic_heap);
+    m.load_database_file(test_database);
+    EXPECT_EQ(m.get_memory_usage().libmagic_heap, libmagic_heap);
+}
+
+TEST(magic_memory_usage_test, opened_magic_get_memory_usage_after_reload)
+{
+    test::create_test_files(test_directory, "magicxx memory usage test");
+    magic m{magic::flags::none, test_database};
+    const auto libmagic_heap = m.get_memory_usage().libmagic_heap;
+    for (int i{}; i < 3; ++i){
+        m.load_database_file(test_database);
+    }
+    EXPECT_EQ(m.get_memory_usage().libmagic_heap, libmagic_heap);
+}
+
+#endif
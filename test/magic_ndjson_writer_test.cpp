@@ -0,0 +1,99 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <magic.hpp>
+#include <magic_ndjson_writer.hpp>
+#include <gtest/gtest.h>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/ndjson_writer"};
+const std::filesystem::path output_file{test_directory / "types.ndjson"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+std::vector<std::string> read_lines(const std::filesystem::path& file)
+{
+    std::ifstream stream{file};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(stream, line);){
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+} /* namespace */
+
+TEST(magic_ndjson_writer_test, ndjson_writer_write)
+{
+    test::create_test_files(test_directory, "magicxx ndjson writer test", "text/x-magicxx");
+    {
+        ndjson_writer writer{output_file};
+        writer.write("/tmp/a\"b\\c\n\x01", magic::expected_file_type_t{"text/plain"});
+        const magic::expected_file_type_t mime{"text/x-c"};
+        writer.write("/tmp/\xc3\xa9\xff\xe2\x82", magic::expected_file_type_t{"C source"}, &mime, 42);
+        writer.write(
+            "/tmp/missing",
+            magic::expected_file_type_t{std::unexpected{magic_error{magic_errc::magic_file_error, ENOENT}}}
+        );
+        EXPECT_EQ(writer.record_count(), 3);
+        EXPECT_TRUE(writer.good());
+    }
+    const auto lines = read_lines(output_file);
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines[0],
+        R"({"path":"/tmp/a\"b\\c\n\u0001","type":"text/plain","mime":null,"error":null,"size":null})"
+    );
+    EXPECT_EQ(lines[1],
+        "{\"path\":\"/tmp/\xc3\xa9\\udcff\\udce2\\udc82\",\"type\":\"C source\",\"mime\":\"text/x-c\",\"error\":null,\"size\":42}"
+    );
+    const auto error_message = magic_error{magic_errc::magic_file_error, ENOENT}.message("/tmp/missing");
+    EXPECT_EQ(lines[2],
+        R"({"path":"/tmp/missing","type":null,"mime":null,"error":")" + error_message + R"(","size":null})"
+    );
+    EXPECT_THROW(ndjson_writer{test_directory / "missing" / "types.ndjson"}, magic_output_error);
+}
+
+TEST(magic_ndjson_writer_test, ndjson_writer_identify_files)
+{
+    test::create_test_files(test_directory, "magicxx ndjson writer test", "text/x-magicxx");
+    magic type_magic{magic::flags::none, test_database};
+    magic mime_magic{magic::flags::mime_type, test_database};
+    const std::vector<std::filesystem::path> files{test_file, {}};
+    {
+        ndjson_writer writer{output_file};
+        writer.identify_files(type_magic, files, &mime_magic);
+        EXPECT_EQ(writer.record_count(), files.size());
+    }
+    const auto lines = read_lines(output_file);
+    ASSERT_EQ(lines.size(), 2);
+    const auto size = std::filesystem::file_size(test_file);
+    EXPECT_EQ(lines[0],
+        "{\"path\":\"" + test_file.string() + "\",\"type\":\"magicxx ndjson writer test\","
+        "\"mime\":\"text/x-magicxx\",\"error\":null,\"size\":" + std::to_string(size) + "}"
+    );
+    EXPECT_EQ(lines[1], R"({"path":"","type":null,"mime":null,"error":"path is empty.","size":null})");
+}
+
+TEST(magic_ndjson_writer_test, ndjson_writer_many_records)
+{
+    test::create_test_files(test_directory, "magicxx ndjson writer test", "text/x-magicxx");
+    {
+        ndjson_writer writer{output_file};
+        for (auto i = 0; i < 5000; ++i){
+            writer.write(test_directory / std::to_string(i), magic::expected_file_type_t{"data"});
+        }
+        EXPECT_TRUE(writer.flush());
+        EXPECT_EQ(read_lines(output_file).size(), 5000);
+    }
+    EXPECT_EQ(read_lines(output_file).size(), 5000);
+}
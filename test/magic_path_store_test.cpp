@@ -0,0 +1,80 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <format>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <magic_path_store.hpp>
+#include <gtest/gtest.h>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/path_store"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+} /* namespace */
+
+TEST(magic_path_store_test, path_store_insert_get_path)
+{
+    path_store store;
+    EXPECT_EQ(store.size(), 1);
+    EXPECT_EQ(store.insert({}), path_store::empty_path_id);
+    EXPECT_EQ(store.get_path(path_store::empty_path_id), std::filesystem::path{});
+    const std::vector<std::filesystem::path> paths{
+        "/", "/usr", "/usr/bin/ls", "/usr/bin/cat", "//double", "/trailing/",
+        "relative", "relative/file", "./dot/../file", "a//b"
+    };
+    std::vector<path_store::path_id_t> path_ids;
+    for (const auto& path : paths){
+        path_ids.push_back(store.insert(path));
+    }
+    for (std::size_t i{}; i < paths.size(); ++i){
+        EXPECT_EQ(store.get_path(path_ids[i]).native(), paths[i].native());
+        EXPECT_EQ(store.insert(paths[i]), path_ids[i]);
+    }
+    EXPECT_EQ(store.get_path(store.insert("/usr/bin")), "/usr/bin");
+    EXPECT_THROW([[maybe_unused]] auto _ = store.get_path(static_cast<path_store::path_id_t>(store.size())), std::out_of_range);
+}
+
+TEST(magic_path_store_test, path_store_shares_prefixes)
+{
+    path_store store;
+    std::size_t path_length{};
+    for (auto i = 0; i < 100000; ++i){
+        const auto path = std::format("/home/user/projects/libmagicxx/build/directory_{}/file_{}", i / 100, i);
+        path_length += path.size();
+        EXPECT_EQ(store.get_path(store.insert(path)), path);
+    }
+    EXPECT_EQ(store.size(), 1 + 6 + 1000 + 100000);
+    EXPECT_LT(store.memory_usage(), path_length);
+}
+
+TEST(magic_path_store_test, compact_types_of_files)
+{
+    test::create_test_files(test_directory, "magicxx path store test");
+    magic m{magic::flags::none, test_database};
+    compact_types_of_files types_of_files;
+    const std::vector<std::filesystem::path> files{test_file, {}, test_file};
+    const auto errors = types_of_files.identify_files(m, files);
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors[0].index, 1);
+    types_of_files.insert("/tmp/other", "data");
+    ASSERT_EQ(types_of_files.size(), 3);
+    EXPECT_EQ(types_of_files.get_path(0), test_file);
+    EXPECT_EQ(types_of_files.get_type(0), "magicxx path store test");
+    EXPECT_EQ(types_of_files.entries()[0].path_id, types_of_files.entries()[1].path_id);
+    EXPECT_EQ(types_of_files.get_types(), (std::vector<std::string_view>{"magicxx path store test", "data"}));
+    const magic::types_of_files_t expected_types_of_files{
+        {test_file, "magicxx path store test"},
+        {"/tmp/other", "data"}
+    };
+    EXPECT_EQ(types_of_files.to_types_of_files(), expected_types_of_files);
+    EXPECT_GT(types_of_files.memory_usage(), types_of_files.get_path_store().memory_usage());
+}
@@ -0,0 +1,135 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <array>
+#include <ranges>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <string_view>
+#include <memory_resource>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/pmr"};
+const std::filesystem::path test_database{"/tmp/test/pmr_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+const std::filesystem::path missing_file{test_directory / "missing_file"};
+
+/**
+ * @brief Counts the allocations of the upstream memory resource.
+ */
+class counting_resource final : public std::pmr::memory_resource {
+public:
+    std::size_t allocations{0};
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    [[nodiscard]]
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * @brief Makes the null memory resource the default one, so that any allocation
+ *        that escapes the memory resource of a result throws std::bad_alloc.
+ */
+class null_default_resource {
+public:
+    null_default_resource()
+        : m_previous{std::pmr::set_default_resource(std::pmr::null_memory_resource())}
+    { }
+
+    ~null_default_resource()
+    {
+        std::pmr::set_default_resource(m_previous);
+    }
+
+private:
+    std::pmr::memory_resource* m_previous;
+};
+
+} /* namespace */
+
+TEST(magic_pmr_test, magic_identify_files_pmr)
+{
+    test::create_test_files(test_directory, "magicxx pmr test, a type longer than the small string buffer", {}, test_database);
+    magic m{magic::flags::error, test_database};
+    const std::vector<std::filesystem::path> files{test_file};
+    counting_resource upstream;
+    std::pmr::monotonic_buffer_resource arena{&upstream};
+    null_default_resource null_default;
+    const auto types_of_files = m.identify_files(files, &arena);
+    EXPECT_EQ(types_of_files.get_allocator().resource(), &arena);
+    ASSERT_EQ(types_of_files.size(), 1);
+    const auto& [path, type] = *types_of_files.begin();
+    EXPECT_EQ(std::string_view{path}, test_file.native());
+    EXPECT_EQ(type, "magicxx pmr test, a type longer than the small string buffer");
+    EXPECT_EQ(type.get_allocator().resource(), &arena);
+    EXPECT_GT(upstream.allocations, 0);
+    EXPECT_EQ(m.identify_files(test_directory, &arena), types_of_files);
+    const std::vector<std::filesystem::path> missing_files{missing_file};
+    EXPECT_THROW(static_cast<void>(m.identify_files(missing_files, &arena)), magic_file_error);
+}
+
+TEST(magic_pmr_test, magic_identify_files_pmr_nothrow)
+{
+    test::create_test_files(test_directory, "magicxx pmr test, a type longer than the small string buffer", {}, test_database);
+    magic m{magic::flags::error, test_database};
+    const std::vector<std::filesystem::path> files{test_file, missing_file};
+    std::array<std::byte, 4096> buffer;
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    null_default_resource null_default;
+    const auto expected_types_of_files = m.identify_files(files, std::nothrow, &arena);
+    ASSERT_EQ(expected_types_of_files.size(), 2);
+    const auto& expected_file_type = expected_types_of_files.at(std::pmr::string{test_file.native(), &arena});
+    ASSERT_TRUE(expected_file_type.has_value());
+    EXPECT_EQ(*expected_file_type, "magicxx pmr test, a type longer than the small string buffer");
+    EXPECT_EQ(expected_file_type->get_allocator().resource(), &arena);
+    const auto& expected_error = expected_types_of_files.at(std::pmr::string{missing_file.native(), &arena});
+    ASSERT_FALSE(expected_error.has_value());
+    EXPECT_EQ(expected_error.error().code(), magic_errc::magic_file_error);
+    magic closed_magic;
+    const auto closed_types_of_files = closed_magic.identify_files(test_directory, std::nothrow, &arena);
+    ASSERT_EQ(closed_types_of_files.size(), 1);
+    EXPECT_EQ(closed_types_of_files.begin()->second.error().code(), magic_errc::magic_is_closed);
+}
+
+TEST(magic_pmr_test, magic_identify_files_pmr_order)
+{
+    test::create_test_files(test_directory, "magicxx pmr test", {}, test_database);
+    std::filesystem::create_directory(test_directory / "a");
+    std::filesystem::copy_file(test_file, test_directory / "a" / "b");
+    std::filesystem::copy_file(test_file, test_directory / "a-b");
+    magic m{magic::flags::none, test_database};
+    std::pmr::monotonic_buffer_resource arena;
+    const auto types_of_files = m.identify_files(test_directory);
+    const auto pmr_types_of_files = m.identify_files(test_directory, &arena);
+    const auto pmr_expected_types_of_files = m.identify_files(test_directory, std::nothrow, &arena);
+    const auto paths = types_of_files | std::views::keys | std::views::transform(
+        [](const std::filesystem::path& path){ return std::string_view{path.native()}; }
+    );
+    ASSERT_EQ(pmr_types_of_files.size(), 4);
+    EXPECT_TRUE(std::ranges::equal(pmr_types_of_files | std::views::keys, paths));
+    EXPECT_TRUE(std::ranges::equal(pmr_expected_types_of_files | std::views::keys, paths));
+    EXPECT_EQ(std::string_view{std::next(pmr_types_of_files.begin())->first}, (test_directory / "a" / "b").native());
+}
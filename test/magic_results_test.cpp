@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <format>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <magic.hpp>
+#include <magic_results.hpp>
+#include <gtest/gtest.h>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/results"};
+const std::filesystem::path results_file{test_directory / "types.magicxx"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+std::string get_type(std::size_t index)
+{
+    return index % 3 == 0 ? "text/plain" : (index % 3 == 1 ? "image/png" : "application/pdf");
+}
+
+} /* namespace */
+
+TEST(magic_results_test, results_write_read)
+{
+    test::create_test_files(test_directory, "magicxx results test");
+    constexpr std::size_t record_count{2 * results::block_size + 100};
+    const magic_error error{magic_errc::magic_file_error, ENOENT, "cannot open `file'"};
+    {
+        results::writer writer{results_file};
+        for (std::size_t i{}; i < record_count; ++i){
+            const auto path = std::format("/data/directory_{}/file_{}", i / 100, i);
+            if (i % 1000 == 999){
+                writer.write(path, std::unexpected{error});
+            } else {
+                writer.write(path, get_type(i), i);
+            }
+        }
+        EXPECT_EQ(writer.record_count(), record_count);
+    }
+    const results::reader reader{results_file};
+    ASSERT_EQ(reader.size(), record_count);
+    EXPECT_EQ(reader.types(), (std::vector<std::string_view>{"text/plain", "image/png", "application/pdf"}));
+    for (auto i : {0uz, 1uz, 15uz, 16uz, 17uz, 999uz, results::block_size - 1, results::block_size, record_count - 1}){
+        const auto record = reader.at(i);
+        EXPECT_EQ(record.path, std::format("/data/directory_{}/file_{}", i / 100, i));
+        if (i % 1000 == 999){
+            ASSERT_FALSE(record.type.has_value());
+            EXPECT_EQ(record.type.error(), error);
+            EXPECT_FALSE(record.size.has_value());
+        } else {
+            ASSERT_TRUE(record.type.has_value());
+            EXPECT_EQ(*record.type, get_type(i));
+            EXPECT_EQ(record.size, i);
+        }
+    }
+    EXPECT_THROW([[maybe_unused]] auto _ = reader.at(record_count), std::out_of_range);
+    const auto images = reader.find("image/png");
+    std::vector<std::size_t> expected_images;
+    for (std::size_t i{}; i < record_count; ++i){
+        if (i % 3 == 1 && i % 1000 != 999){
+            expected_images.push_back(i);
+        }
+    }
+    EXPECT_EQ(images, expected_images);
+    EXPECT_TRUE(reader.find("video/mp4").empty());
+    const auto text_and_pdf = reader.find_if([](std::string_view type){
+        return type != "image/png";
+    });
+    EXPECT_EQ(text_and_pdf.size() + images.size() + record_count / 1000, record_count);
+}
+
+TEST(magic_results_test, results_identify_files)
+{
+    test::create_test_files(test_directory, "magicxx results test");
+    magic m{magic::flags::none, test_database};
+    const std::vector<std::filesystem::path> files{test_file, {}};
+    {
+        results::writer writer{results_file};
+        writer.identify_files(m, files);
+        writer.close();
+        EXPECT_THROW(writer.write(test_file, "data"), magic_results_error);
+    }
+    results::reader reader{results_file};
+    ASSERT_EQ(reader.size(), 2);
+    const auto record = reader.at(0);
+    EXPECT_EQ(record.path, test_file);
+    EXPECT_EQ(record.type, "magicxx results test");
+    EXPECT_EQ(record.size, std::filesystem::file_size(test_file));
+    EXPECT_EQ(reader.at(1).type.error().code(), magic_errc::empty_path);
+    auto moved_reader = std::move(reader);
+    EXPECT_EQ(moved_reader.size(), 2);
+    EXPECT_EQ(moved_reader.find("magicxx results test"), std::vector<std::size_t>{0});
+}
+
+TEST(magic_results_test, results_malformed_file)
+{
+    test::create_test_files(test_directory, "magicxx results test");
+    EXPECT_THROW(results::reader{test_directory / "missing"}, magic_results_error);
+    EXPECT_THROW(results::reader{test_file}, magic_results_error);
+    EXPECT_THROW(results::writer{test_directory / "missing" / "types.magicxx"}, magic_results_error);
+    {
+        results::writer writer{results_file};
+        writer.write(test_file, "data");
+    }
+    std::filesystem::resize_file(results_file, std::filesystem::file_size(results_file) - 1);
+    EXPECT_THROW(results::reader{results_file}, magic_results_error);
+}
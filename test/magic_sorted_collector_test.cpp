@@ -0,0 +1,196 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <map>
+#include <cerrno>
+#include <format>
+#include <csignal>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/resource.h>
+
+#include <magic.hpp>
+#include <magic_results.hpp>
+#include <gtest/gtest.h>
+#include <magic_sorted_collector.hpp>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/sorted_collector"};
+const std::filesystem::path run_directory{"/tmp/test/sorted_collector_runs"};
+const std::filesystem::path results_file{test_directory / "types.magicxx"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+void create_test_files()
+{
+    test::create_test_files(test_directory, "magicxx sorted collector test");
+    std::filesystem::remove_all(run_directory);
+    std::filesystem::create_directories(run_directory);
+}
+
+using collected_t = std::vector<std::pair<std::string, std::string>>;
+
+collected_t collect(results::sorted_collector& collector)
+{
+    collected_t collected;
+    collector.for_each(
+        [&](const results::record& current){
+            collected.emplace_back(
+                current.path.string(),
+                current.type ? std::string{*current.type} : current.type.error().message()
+            );
+        }
+    );
+    return collected;
+}
+
+} /* namespace */
+
+TEST(magic_sorted_collector_test, compare_paths)
+{
+    const std::vector<std::string> paths{
+        "", "/", "a", "/a", "a/", "a/b", "a-b", "a.b", "a//b", "a/b/", "/a/b",
+        "ab", "a/bc", "a/b/c", "b", "/b", "B", "a/\xff", "a/ b"
+    };
+    for (const auto& first : paths){
+        for (const auto& second : paths){
+            EXPECT_EQ(
+                results::compare_paths(first, second),
+                std::filesystem::path{first}.compare(second) <=> 0
+            ) << first << " " << second;
+        }
+    }
+}
+
+TEST(magic_sorted_collector_test, sorted_collector_in_memory)
+{
+    create_test_files();
+    results::sorted_collector collector{results::sorted_collector::default_memory_budget, run_directory};
+    collector.insert("/data/b/file", std::string{"image/png"}, 10);
+    collector.insert("/data/a-b", std::string{"text/plain"});
+    collector.insert("/data/a/file", std::unexpected{magic_error{magic_errc::magic_file_error, ENOENT}});
+    collector.insert("/data/b/file", std::string{"application/pdf"}, 20);
+    EXPECT_EQ(collector.record_count(), 4);
+    EXPECT_EQ(collector.run_count(), 0);
+    EXPECT_GT(collector.memory_usage(), 0);
+    const collected_t expected_collected{
+        {"/data/a/file", magic_error{magic_errc::magic_file_error, ENOENT}.message()},
+        {"/data/a-b", "text/plain"},
+        {"/data/b/file", "application/pdf"}
+    };
+    EXPECT_EQ(collect(collector), expected_collected);
+    EXPECT_TRUE(std::filesystem::is_empty(run_directory));
+}
+
+TEST(magic_sorted_collector_test, sorted_collector_spill)
+{
+    create_test_files();
+    constexpr std::size_t record_count{20000};
+    std::vector<std::size_t> indexes(record_count);
+    std::ranges::generate(indexes, [i = 0uz]() mutable { return i++ % (record_count / 2); });
+    std::ranges::shuffle(indexes, std::mt19937{42});
+    std::map<std::filesystem::path, std::string> expected_types;
+    {
+        results::sorted_collector collector{4096, run_directory};
+        for (std::size_t i{}; i < record_count; ++i){
+            const auto path = std::format("/data/directory_{}/file_{}", indexes[i] % 97, indexes[i]);
+            if (i % 10 == 0){
+                const magic_error error{magic_errc::magic_file_error, ENOENT, std::format("cannot open file_{}", i)};
+                collector.insert(path, std::unexpected{error}, i);
+                expected_types[path] = error.message();
+            } else {
+                const auto type = std::format("type_{}", i);
+                collector.insert(path, type, i);
+                expected_types[path] = type;
+            }
+        }
+        EXPECT_EQ(collector.record_count(), record_count);
+        EXPECT_GT(collector.run_count(), results::sorted_collector::merge_width);
+        EXPECT_LT(collector.memory_usage(), 4096);
+        collected_t expected_collected;
+        for (const auto& [path, type] : expected_types){
+            expected_collected.emplace_back(path.string(), type);
+        }
+        EXPECT_EQ(collect(collector), expected_collected);
+        EXPECT_LE(collector.run_count(), results::sorted_collector::merge_width);
+        {
+            results::writer writer{results_file};
+            collector.write(writer);
+        }
+        const results::reader reader{results_file};
+        ASSERT_EQ(reader.size(), expected_types.size());
+        for (std::size_t i{}; const auto& [path, type] : expected_types){
+            const auto record = reader.at(i++);
+            EXPECT_EQ(record.path, path);
+            EXPECT_EQ(record.type ? std::string{*record.type} : record.type.error().message(), type);
+        }
+        EXPECT_EQ(reader.at(reader.size() - 1).path, expected_types.rbegin()->first);
+    }
+    EXPECT_TRUE(std::filesystem::is_empty(run_directory));
+}
+
+TEST(magic_sorted_collector_test, sorted_collector_identify_files)
+{
+    create_test_files();
+    magic m{magic::flags::none, test_database};
+    results::sorted_collector collector{0, run_directory};
+    collector.identify_files(m, test_directory);
+    const std::vector<std::filesystem::path> files{test_file};
+    collector.identify_files(m, files);
+    EXPECT_EQ(collector.run_count(), 3);
+    const auto types_of_files = m.identify_files(test_directory);
+    collected_t expected_collected;
+    for (const auto& [path, type] : types_of_files){
+        expected_collected.emplace_back(path.string(), type);
+    }
+    EXPECT_EQ(collect(collector), expected_collected);
+}
+
+TEST(magic_sorted_collector_test, sorted_collector_spill_into_unwritable_directory)
+{
+    using enum std::filesystem::perms;
+    create_test_files();
+    std::filesystem::permissions(run_directory, owner_read | owner_exec);
+    if (::access(run_directory.c_str(), W_OK) == 0){
+        std::filesystem::permissions(run_directory, owner_all);
+        GTEST_SKIP() << "the run directory is writable regardless of its permissions";
+    }
+    results::sorted_collector collector{0, run_directory};
+    EXPECT_THROW(collector.insert("/data/file", std::string{"text/plain"}), magic_output_error);
+    EXPECT_EQ(collector.run_count(), 0);
+    std::filesystem::permissions(run_directory, owner_all);
+    EXPECT_TRUE(std::filesystem::is_empty(run_directory));
+}
+
+TEST(magic_sorted_collector_test, sorted_collector_spill_failure_removes_the_run_file)
+{
+    create_test_files();
+    rlimit file_size_limit{};
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &file_size_limit), 0);
+    const auto file_size_signal_handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit spill_file_size_limit{4096, file_size_limit.rlim_max};
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &spill_file_size_limit), 0);
+    {
+        results::sorted_collector collector{1024 * 1024, run_directory};
+        EXPECT_THROW(
+            for (std::size_t i{}; collector.run_count() == 0; ++i){
+                collector.insert(std::format("/data/directory/file_{}", i), std::string{"text/plain"});
+            },
+            magic_output_error
+        );
+        EXPECT_EQ(collector.run_count(), 0);
+        EXPECT_TRUE(std::filesystem::is_empty(run_directory));
+    }
+    ::setrlimit(RLIMIT_FSIZE, &file_size_limit);
+    std::signal(SIGXFSZ, file_size_signal_handler);
+}
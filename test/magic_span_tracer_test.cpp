@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/span_tracer"};
+const std::filesystem::path chrome_trace_file{test_directory / "magicxx.json"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+
+/**
+ * @brief Collects the spans as "+name" and "-name" events, and checks their times.
+ */
+class collecting_tracer final : public trace::span_tracer {
+public:
+    std::vector<std::string> events;
+    std::vector<std::string> details;
+    bool ordered{true};
+
+    void begin(std::string_view name, std::string_view detail, clock_t::time_point time) noexcept override
+    {
+        events.push_back("+" + std::string{name});
+        details.emplace_back(detail);
+        m_begin_times.push_back(time);
+    }
+
+    void end(std::string_view name, clock_t::time_point time) noexcept override
+    {
+        events.push_back("-" + std::string{name});
+        ordered = ordered && !m_begin_times.empty() && m_begin_times.back() <= time;
+        m_begin_times.pop_back();
+    }
+
+private:
+    std::vector<clock_t::time_point> m_begin_times;
+};
+
+} /* namespace */
+
+TEST(magic_span_tracer_test, magic_set_span_tracer)
+{
+    test::create_test_files(test_directory, "magicxx span tracer test");
+    auto tracer = std::make_shared<collecting_tracer>();
+    magic m{magic::flags::none, test_database};
+    EXPECT_EQ(m.get_span_tracer(), nullptr);
+    m.set_span_tracer(tracer);
+    EXPECT_EQ(m.get_span_tracer(), tracer);
+    m.load_database_file(test_database);
+    static_cast<void>(m.identify_file(test_file));
+    static_cast<void>(m.identify_file(test_file, std::nothrow));
+    const std::vector<std::string> expected_events{
+        "+load_database_file", "-load_database_file",
+        "+identify_file", "-identify_file",
+        "+identify_file_nothrow", "-identify_file_nothrow"
+    };
+    EXPECT_EQ(tracer->events, expected_events);
+    EXPECT_EQ(tracer->details[0], test_database.string());
+    EXPECT_EQ(tracer->details[1], test_file.string());
+    EXPECT_TRUE(tracer->ordered);
+    m.set_span_tracer(nullptr);
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_EQ(tracer->events.size(), expected_events.size());
+}
+
+TEST(magic_span_tracer_test, magic_span_tracer_stages)
+{
+    test::create_test_files(test_directory, "magicxx span tracer test");
+    auto tracer = std::make_shared<collecting_tracer>();
+    magic m{magic::flags::none, test_database};
+    m.set_span_tracer(tracer);
+    m.enable_stage_timing();
+    const std::vector<std::filesystem::path> files{test_file};
+    static_cast<void>(m.identify_files(files));
+    const std::vector<std::string> expected_events{
+        "+traversal", "-traversal",
+        "+identify_file",
+        "+stat", "-stat", "+open", "-open",
+        "+classify", "-classify", "+conversion", "-conversion",
+        "-identify_file"
+    };
+    EXPECT_EQ(tracer->events, expected_events);
+    EXPECT_TRUE(tracer->ordered);
+}
+
+TEST(magic_span_tracer_test, chrome_trace_writer)
+{
+    test::create_test_files(test_directory, "magicxx span tracer test");
+    {
+        auto writer = std::make_shared<trace::chrome_trace_writer>(chrome_trace_file);
+        EXPECT_EQ(writer->file(), chrome_trace_file);
+        magic m{magic::flags::none, test_database};
+        m.set_span_tracer(writer);
+        static_cast<void>(m.identify_file(test_directory / "file \"quoted\"", std::nothrow));
+    }
+    std::ifstream file{chrome_trace_file};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const auto json = contents.str();
+    EXPECT_TRUE(json.starts_with("[\n{\"name\":\"identify_file_nothrow\",\"cat\":\"magicxx\",\"ph\":\"B\""));
+    EXPECT_NE(json.find(R"(file \"quoted\")"), std::string::npos);
+    EXPECT_NE(json.find(R"("ph":"E")"), std::string::npos);
+    EXPECT_TRUE(json.ends_with("}\n]\n"));
+    EXPECT_THROW(trace::chrome_trace_writer{test_directory / "missing" / "magicxx.json"}, magic_trace_error);
+}
@@ -0,0 +1,258 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <vector>
+#include <thread>
+#include <fstream>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+#include <magicxx_test_database.hpp>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+using namespace std::chrono_literals;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/statistics"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+const std::filesystem::path missing_file{test_directory / "missing_file"};
+
+} /* namespace */
+
+TEST(magic_statistics_test, latency_histogram_buckets)
+{
+    for (std::size_t i{}; i < latency_histogram::bucket_count; ++i){
+        EXPECT_EQ(latency_histogram::index_of(latency_histogram::lowest_value_of(i)), i);
+        EXPECT_EQ(latency_histogram::index_of(latency_histogram::highest_value_of(i)), i);
+        const auto lowest = latency_histogram::lowest_value_of(i);
+        EXPECT_LE(latency_histogram::highest_value_of(i) - lowest, lowest / latency_histogram::sub_bucket_count);
+    }
+    EXPECT_EQ(latency_histogram::index_of(~0ULL), latency_histogram::bucket_count - 1);
+}
+
+TEST(magic_statistics_test, latency_histogram_record_merge_percentile)
+{
+    latency_histogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(50), 0ns);
+    for (auto latency = 1us; latency <= 100us; latency += 1us){
+        histogram.record(latency);
+    }
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.min(), 1us);
+    EXPECT_EQ(histogram.max(), 100us);
+    EXPECT_EQ(histogram.mean(), 50500ns);
+    EXPECT_NEAR(histogram.percentile(50).count(), 50000, 50000 / latency_histogram::sub_bucket_count);
+    EXPECT_NEAR(histogram.percentile(99).count(), 99000, 99000 / latency_histogram::sub_bucket_count);
+    EXPECT_EQ(histogram.percentile(100), 100us);
+    latency_histogram other;
+    other.record(1s);
+    histogram.merge(other);
+    EXPECT_EQ(histogram.count(), 101);
+    EXPECT_EQ(histogram.min(), 1us);
+    EXPECT_EQ(histogram.max(), 1s);
+    EXPECT_EQ(histogram.percentile(100), 1s);
+}
+
+TEST(magic_statistics_test, identification_stage_to_string)
+{
+    EXPECT_EQ(to_string(identification_stage::traversal), "traversal");
+    EXPECT_EQ(to_string(identification_stage::conversion), "conversion");
+}
+
+TEST(magic_statistics_test, opened_magic_stage_timing)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    std::filesystem::create_directories(test_directory / "directory");
+    std::ofstream{test_directory / "directory" / "empty_file"};
+    std::filesystem::create_symlink(test_file, test_directory / "symlink");
+    magic m{magic::flags::none, test_database};
+    EXPECT_FALSE(m.is_stage_timing_enabled());
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_EQ(m.get_stage_durations(), stage_durations_t{});
+    const auto types_of_files = m.identify_files(test_directory);
+    const auto missing_file_type = m.identify_file(missing_file, std::nothrow);
+    m.enable_stage_timing();
+    EXPECT_TRUE(m.is_stage_timing_enabled());
+    EXPECT_EQ(m.identify_files(test_directory), types_of_files);
+    EXPECT_EQ(m.identify_file(test_file), "magicxx statistics test");
+    const auto stage_durations = m.get_stage_durations();
+    EXPECT_EQ(stage_durations[std::to_underlying(identification_stage::traversal)], 0ns);
+    EXPECT_GT(stage_durations[std::to_underlying(identification_stage::open)], 0ns);
+    EXPECT_GT(stage_durations[std::to_underlying(identification_stage::classify)], 0ns);
+    EXPECT_EQ(m.identify_file(missing_file, std::nothrow), missing_file_type);
+    m.enable_stage_timing(false);
+    EXPECT_FALSE(m.is_stage_timing_enabled());
+}
+
+TEST(magic_statistics_test, statistics_to_openmetrics)
+{
+    magic_statistics statistics;
+    statistics.calls = 3;
+    statistics.errors = 1;
+    statistics.errors_by_type[std::to_underlying(identification_error::empty_path)] = 1;
+    statistics.cache_hits = 4;
+    statistics.latency.record(5ns);
+    statistics.latency.record(1us);
+    statistics.type_costs["PDF \"document\""] = type_cost{.calls = 2, .bytes = 10, .latency = 1s, .max_latency = 1s};
+    const auto metrics = to_openmetrics(statistics, "test");
+    EXPECT_TRUE(metrics.starts_with("# TYPE test_identifications counter\n"));
+    EXPECT_TRUE(metrics.ends_with("# EOF\n"));
+    EXPECT_NE(metrics.find("test_identifications_total 3\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_identification_errors_total{type=\"empty_path\"} 1\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_identification_errors_total{type=\"magic_file_error\"} 0\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_dispatch_index_cache_lookups_total{result=\"hit\"} 4\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_identification_latency_seconds_bucket{le=\"7e-09\"} 1\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_identification_latency_seconds_bucket{le=\"+Inf\"} 2\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_identification_latency_seconds_count 2\n"), std::string::npos);
+    EXPECT_NE(metrics.find("test_type_identifications_total{type=\"PDF \\\"document\\\"\"} 2\n"), std::string::npos);
+    EXPECT_EQ(to_string(identification_error::magic_is_closed), "magic_is_closed");
+}
+
+#ifndef MAGICXX_DISABLE_STATISTICS
+
+TEST(magic_statistics_test, opened_magic_get_statistics)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    magic m{magic::flags::error};
+    EXPECT_FALSE(m.is_statistics_enabled());
+    m.enable_statistics();
+    EXPECT_TRUE(m.is_statistics_enabled());
+    m.enable_stage_timing();
+    m.load_database_file(test_database);
+    EXPECT_EQ(m.get_statistics().calls, 0);
+    EXPECT_EQ(m.identify_file(test_file), "magicxx statistics test");
+    EXPECT_FALSE(m.identify_file(missing_file, std::nothrow).has_value());
+    EXPECT_THROW(static_cast<void>(m.identify_file(missing_file)), magic_file_error);
+    const std::vector<std::filesystem::path> files{test_file, test_file};
+    EXPECT_EQ(m.identify_files(files).size(), 1);
+    const auto statistics = m.get_statistics();
+    EXPECT_EQ(statistics.calls, 5);
+    EXPECT_EQ(statistics.errors, 2);
+    EXPECT_EQ(statistics.errors_by_type[std::to_underlying(identification_error::magic_file_error)], 2);
+    EXPECT_EQ(statistics.database_loads, 1);
+    EXPECT_EQ(statistics.bytes, 3 * std::filesystem::file_size(test_file));
+    EXPECT_EQ(statistics.latency.count(), 5);
+    EXPECT_GT(statistics.latency.max(), 0ns);
+    EXPECT_LE(statistics.latency.min(), statistics.latency.percentile(50));
+    EXPECT_LE(statistics.latency.percentile(50), statistics.latency.max());
+}
+
+TEST(magic_statistics_test, opened_magic_reset_statistics)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    magic m{magic::flags::none, test_database};
+    m.enable_statistics();
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_EQ(m.get_statistics().calls, 1);
+    m.reset_statistics();
+    const auto statistics = m.get_statistics();
+    EXPECT_EQ(statistics.calls, 0);
+    EXPECT_EQ(statistics.bytes, 0);
+    EXPECT_EQ(statistics.latency.count(), 0);
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_EQ(m.get_statistics().calls, 1);
+    magic moved{std::move(m)};
+    EXPECT_TRUE(moved.is_statistics_enabled());
+    EXPECT_EQ(moved.get_statistics().calls, 1);
+    EXPECT_EQ(m.get_statistics().calls, 0);
+}
+
+TEST(magic_statistics_test, opened_magic_get_statistics_from_threads)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t calls = 64;
+    magic m{magic::flags::none, test_database};
+    std::vector<std::jthread> threads;
+    for (std::size_t i{}; i < thread_count; ++i){
+        threads.emplace_back([&]{
+            magic thread_magic{magic::flags::none, test_database};
+            thread_magic.enable_statistics();
+            for (std::size_t j{}; j < calls; ++j){
+                static_cast<void>(thread_magic.identify_file(test_file));
+            }
+            EXPECT_EQ(thread_magic.get_statistics().calls, calls);
+        });
+    }
+    threads.clear();
+    EXPECT_EQ(m.get_statistics().calls, 0);
+}
+
+TEST(magic_statistics_test, opened_magic_dispatch_index_cache_statistics)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    magic m{magic::flags::none};
+    m.load_database_buffer(databases::magicxx_test_database());
+    m.enable_statistics();
+    m.enable_dispatch_index();
+    static_cast<void>(m.identify_file(test_file));
+    static_cast<void>(m.identify_file(test_file));
+    const auto statistics = m.get_statistics();
+    EXPECT_EQ(statistics.cache_hits + statistics.cache_misses, 2);
+    EXPECT_EQ(statistics.cache_misses, 1);
+}
+
+TEST(magic_statistics_test, opened_magic_stage_timing_statistics)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    magic m{magic::flags::none, test_database};
+    m.enable_statistics();
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_EQ(m.get_statistics().timed_calls, 0);
+    m.enable_stage_timing();
+    const std::vector<std::filesystem::path> files{test_file, test_database};
+    static_cast<void>(m.identify_files(files));
+    const auto statistics = m.get_statistics();
+    EXPECT_EQ(statistics.calls, 3);
+    EXPECT_EQ(statistics.timed_calls, 2);
+    EXPECT_EQ(statistics.bytes, std::filesystem::file_size(test_file) + std::filesystem::file_size(test_database));
+    EXPECT_GT(statistics.stage_durations[std::to_underlying(identification_stage::traversal)], 0ns);
+    EXPECT_GT(statistics.stage_durations[std::to_underlying(identification_stage::classify)], 0ns);
+    m.reset_statistics();
+    EXPECT_EQ(m.get_statistics().stage_durations, stage_durations_t{});
+    m.enable_statistics(false);
+    static_cast<void>(m.identify_file(test_file));
+    m.enable_stage_timing(false);
+    m.enable_statistics();
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_EQ(m.get_statistics().bytes, 0);
+}
+
+TEST(magic_statistics_test, opened_magic_type_statistics)
+{
+    test::create_test_files(test_directory, "magicxx statistics test");
+    std::ofstream{test_directory / "other_file"} << "MAGICXX other file\n";
+    magic m{magic::flags::error, test_database};
+    m.enable_stage_timing();
+    EXPECT_FALSE(m.is_type_statistics_enabled());
+    static_cast<void>(m.identify_file(test_file));
+    EXPECT_TRUE(m.get_statistics().type_costs.empty());
+    EXPECT_EQ(m.get_statistics().calls, 0);
+    m.enable_type_statistics();
+    EXPECT_TRUE(m.is_type_statistics_enabled());
+    static_cast<void>(m.identify_file(test_file));
+    static_cast<void>(m.identify_file(test_directory / "other_file"));
+    static_cast<void>(m.identify_file(missing_file, std::nothrow));
+    m.set_flags(magic::flags::mime);
+    static_cast<void>(m.identify_file(test_file, std::nothrow));
+    const auto type_costs = m.get_statistics().type_costs;
+    ASSERT_EQ(type_costs.size(), 2);
+    const auto& test_type_cost = type_costs.at("magicxx statistics test");
+    EXPECT_EQ(test_type_cost.calls, 2);
+    EXPECT_EQ(test_type_cost.bytes, std::filesystem::file_size(test_file) + std::filesystem::file_size(test_directory / "other_file"));
+    EXPECT_GT(test_type_cost.latency, 0ns);
+    EXPECT_LE(test_type_cost.max_latency, test_type_cost.latency);
+    EXPECT_EQ(type_costs.at("text/plain").calls, 1);
+    const auto report = to_string(type_costs);
+    EXPECT_NE(report.find("magicxx statistics test"), std::string::npos);
+    EXPECT_LT(report.find("share"), report.find("text/plain"));
+    m.reset_statistics();
+    EXPECT_TRUE(m.get_statistics().type_costs.empty());
+}
+
+#endif
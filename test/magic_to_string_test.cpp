@@ -0,0 +1,98 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <format>
+#include <string>
+#include <cstdio>
+#include <sstream>
+#include <unistd.h>
+
+#include <magic.hpp>
+#include <gtest/gtest.h>
+
+using namespace recognition;
+
+namespace {
+
+const magic::types_of_files_t types_of_files{
+    {"/tmp/a", "text/plain"},
+    {"/tmp/b", "inode/directory"},
+    {"/tmp/c", "application/octet-stream"}
+};
+
+const magic::expected_types_of_files_t expected_types_of_files{
+    {"/tmp/a", "text/plain"},
+    {"/tmp/b", std::unexpected{magic_error{magic_errc::magic_file_error, ENOENT}}}
+};
+
+const std::string types_of_files_string{
+    "/tmp/a -> text/plain\n"
+    "/tmp/b -> inode/directory\n"
+    "/tmp/c -> application/octet-stream"
+};
+
+} /* namespace */
+
+TEST(magic_to_string_test, types_of_files_to_string)
+{
+    EXPECT_EQ(to_string(types_of_files), types_of_files_string);
+    EXPECT_EQ(to_string(types_of_files, ": ", ", "), "/tmp/a: text/plain, /tmp/b: inode/directory, /tmp/c: application/octet-stream");
+    EXPECT_TRUE(to_string(magic::types_of_files_t{}).empty());
+    const auto error_message = magic_error{magic_errc::magic_file_error, ENOENT}.message("/tmp/b");
+    EXPECT_EQ(to_string(expected_types_of_files), "/tmp/a -> text/plain\n/tmp/b -> " + error_message);
+}
+
+TEST(magic_to_string_test, types_of_files_write_to_stream)
+{
+    std::ostringstream stream;
+    EXPECT_TRUE(write_to(stream, types_of_files).good());
+    EXPECT_EQ(stream.str(), types_of_files_string);
+    std::ostringstream expected_stream;
+    write_to(expected_stream, expected_types_of_files, ": ", ", ");
+    EXPECT_EQ(expected_stream.str(), to_string(expected_types_of_files, ": ", ", "));
+}
+
+TEST(magic_to_string_test, types_of_files_write_to_file_descriptor)
+{
+    magic::types_of_files_t many_types_of_files;
+    for (auto i = 0; i < 10000; ++i){
+        many_types_of_files[std::format("/tmp/file_{}", i)] = "text/plain; charset=us-ascii";
+    }
+    auto file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    EXPECT_TRUE(write_to(::fileno(file), many_types_of_files));
+    std::rewind(file);
+    std::string contents;
+    for (int character; (character = std::fgetc(file)) != EOF;){
+        contents += static_cast<char>(character);
+    }
+    std::fclose(file);
+    EXPECT_EQ(contents, to_string(many_types_of_files));
+    EXPECT_FALSE(write_to(-1, types_of_files));
+}
+
+TEST(magic_to_string_test, result_formatters)
+{
+    EXPECT_EQ(std::format("{}", magic::flags::mime_type), to_string(magic::flags::mime_type));
+    EXPECT_EQ(std::format("{}", magic::parameters::bytes_max), to_string(magic::parameters::bytes_max));
+    EXPECT_EQ(std::format("{}", magic::expected_file_type_t{"text/plain"}), "text/plain");
+    EXPECT_EQ(std::format("{}", magic_error{magic_errc::empty_path}), "path is empty.");
+    EXPECT_EQ(
+        std::format("{}", magic::expected_file_type_t{std::unexpected{magic_error{magic_errc::magic_is_closed}}}),
+        "magic is closed."
+    );
+    const magic::partial_types_of_files partial_types_of_files{
+        {{"/tmp/a", "text/plain"}},
+        {{1, magic_error{magic_errc::empty_path}}}
+    };
+    EXPECT_EQ(std::format("{}", partial_types_of_files), "/tmp/a -> text/plain\n#1 -> path is empty.\n");
+    EXPECT_THROW(
+        static_cast<void>(std::vformat("{:>10}", std::make_format_args(partial_types_of_files))),
+        std::format_error
+    );
+    EXPECT_THROW(
+        static_cast<void>(std::vformat("{:d}", std::make_format_args(partial_types_of_files))),
+        std::format_error
+    );
+}
@@ -0,0 +1,123 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <vector>
+#include <fstream>
+
+#include <magic.hpp>
+#include <magic_trace.hpp>
+#include <gtest/gtest.h>
+#include <magicxx_test_database.hpp>
+
+#include "test_files.hpp"
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/trace"};
+const std::filesystem::path trace_file{test_directory / "magicxx.trace"};
+const std::filesystem::path test_database{test_directory / "test_database"};
+const std::filesystem::path test_file{test_directory / "test_file"};
+const std::filesystem::path missing_file{test_directory / "missing_file"};
+
+} /* namespace */
+
+TEST(magic_trace_test, magic_start_recording_stop_recording)
+{
+    test::create_test_files(test_directory, "magicxx trace test");
+    magic m;
+    EXPECT_FALSE(m.is_recording());
+    m.start_recording(trace_file);
+    EXPECT_TRUE(m.is_recording());
+    m.stop_recording();
+    EXPECT_FALSE(m.is_recording());
+    EXPECT_TRUE(trace::read(trace_file).empty());
+}
+
+TEST(magic_trace_test, magic_start_recording_invalid_trace_file)
+{
+    magic m;
+    EXPECT_THROW(m.start_recording({}), empty_path);
+    EXPECT_THROW(m.start_recording(missing_file / "magicxx.trace"), magic_trace_error);
+    EXPECT_FALSE(m.is_recording());
+}
+
+TEST(magic_trace_test, opened_magic_record_calls)
+{
+    test::create_test_files(test_directory, "magicxx trace test");
+    magic m{magic::flags::none};
+    m.start_recording(trace_file);
+    m.load_database_file(test_database);
+    EXPECT_EQ(m.identify_file(test_file), "magicxx trace test");
+    m.set_flags(magic::flags::error);
+    EXPECT_FALSE(m.identify_file(missing_file, std::nothrow).has_value());
+    EXPECT_THROW(static_cast<void>(m.identify_file(missing_file)), magic_file_error);
+    m.stop_recording();
+    EXPECT_EQ(m.identify_file(test_file), "magicxx trace test");
+    const auto records = trace::read(trace_file);
+    ASSERT_EQ(records.size(), 4);
+    EXPECT_EQ(records[0].kind, trace::call::load_database_file);
+    EXPECT_EQ(records[0].path, test_database);
+    EXPECT_TRUE(records[0].succeeded);
+    EXPECT_EQ(records[1].kind, trace::call::identify_file);
+    EXPECT_EQ(records[1].path, test_file);
+    EXPECT_EQ(records[1].flags_mask, magic::flags::none);
+    EXPECT_TRUE(records[1].succeeded);
+    EXPECT_EQ(records[2].kind, trace::call::identify_file_nothrow);
+    EXPECT_EQ(records[2].path, missing_file);
+    EXPECT_FALSE(records[2].succeeded);
+    EXPECT_EQ(records[3].kind, trace::call::identify_file);
+    EXPECT_EQ(records[3].flags_mask, magic::flags::error);
+    EXPECT_FALSE(records[3].succeeded);
+    for (std::size_t i{1}; i < records.size(); ++i){
+        EXPECT_GE(records[i].offset, records[i - 1].offset + records[i - 1].duration);
+        EXPECT_TRUE(records[i].prefix.empty());
+    }
+}
+
+TEST(magic_trace_test, opened_magic_record_identify_files_with_prefix)
+{
+    test::create_test_files(test_directory, "magicxx trace test");
+    magic m{magic::flags::none};
+    m.load_database_file(test_database);
+    m.start_recording(trace_file, 7);
+    const std::vector<std::filesystem::path> files{test_file, test_database};
+    EXPECT_EQ(m.identify_files(files).size(), 2);
+    m.stop_recording();
+    const auto records = trace::read(trace_file);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].path, test_file);
+    EXPECT_EQ(records[0].prefix, "MAGICXX");
+    EXPECT_EQ(records[0].input_hash, trace::hash("MAGICXX"));
+    EXPECT_EQ(records[1].path, test_database);
+    EXPECT_EQ(records[1].prefix, "0\tstrin");
+}
+
+TEST(magic_trace_test, opened_magic_record_load_database_buffer)
+{
+    test::create_test_files(test_directory, "magicxx trace test");
+    magic m{magic::flags::none};
+    m.start_recording(trace_file);
+    const auto database = databases::magicxx_test_database();
+    m.load_database_buffer(database);
+    m.stop_recording();
+    const auto records = trace::read(trace_file);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].kind, trace::call::load_database_buffer);
+    EXPECT_TRUE(records[0].path.empty());
+    EXPECT_EQ(records[0].input_hash, trace::hash({database.data(), database.size()}));
+}
+
+TEST(magic_trace_test, trace_read_malformed_trace_file)
+{
+    test::create_test_files(test_directory, "magicxx trace test");
+    EXPECT_THROW(static_cast<void>(trace::read(missing_file)), magic_trace_error);
+    EXPECT_THROW(static_cast<void>(trace::read(test_file)), magic_trace_error);
+    magic m{magic::flags::none};
+    m.start_recording(trace_file);
+    static_cast<void>(m.identify_file(test_file, std::nothrow));
+    m.stop_recording();
+    std::filesystem::resize_file(trace_file, std::filesystem::file_size(trace_file) - 1);
+    EXPECT_THROW(static_cast<void>(trace::read(trace_file)), magic_trace_error);
+}
@@ -0,0 +1,95 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#include <cerrno>
+#include <format>
+#include <string>
+#include <vector>
+
+#include <magic_type_index.hpp>
+#include <gtest/gtest.h>
+
+using namespace recognition;
+
+namespace {
+
+const std::filesystem::path test_directory{"/tmp/test/type_index"};
+const std::filesystem::path results_file{test_directory / "types.magicxx"};
+const std::filesystem::path index_file{test_directory / "types.magicxxi"};
+
+void create_test_directory()
+{
+    std::filesystem::remove_all(test_directory);
+    std::filesystem::create_directories(test_directory);
+}
+
+} /* namespace */
+
+TEST(magic_type_index_test, type_index_from_results)
+{
+    create_test_directory();
+    constexpr std::size_t record_count{10000};
+    {
+        results::writer writer{results_file};
+        for (std::size_t i{}; i < record_count; ++i){
+            const auto path = std::format("/data/file_{}", i);
+            if (i % 100 == 0){
+                writer.write(path, std::unexpected{magic_error{magic_errc::magic_file_error, ENOENT}});
+            } else {
+                writer.write(path, i % 10 == 7 ? "application/x-executable" : "text/plain");
+            }
+        }
+    }
+    results::type_index_builder builder;
+    builder.add(results::reader{results_file});
+    builder.save(index_file);
+    const results::type_index index{index_file};
+    EXPECT_EQ(index.types(), (std::vector<std::string_view>{"application/x-executable", "text/plain"}));
+    std::vector<std::uint64_t> expected_executables;
+    for (std::size_t i{7}; i < record_count; i += 10){
+        expected_executables.push_back(i);
+    }
+    EXPECT_EQ(index.find("application/x-executable"), expected_executables);
+    EXPECT_EQ(index.count("application/x-executable"), expected_executables.size());
+    EXPECT_EQ(index.count("text/plain"), record_count - expected_executables.size() - record_count / 100);
+    EXPECT_TRUE(index.find("image/png").empty());
+    EXPECT_EQ(index.count("image/png"), 0);
+}
+
+TEST(magic_type_index_test, type_index_apply_changes)
+{
+    create_test_directory();
+    results::type_index_builder builder;
+    builder.add(5, "text/plain");
+    builder.add(1, "text/plain");
+    builder.add(3, "image/png");
+    builder.add(1, "text/plain");
+    builder.save(index_file);
+    results::type_index index{index_file};
+    EXPECT_EQ(index.find("text/plain"), (std::vector<std::uint64_t>{1, 5}));
+    results::type_index_builder updater{index};
+    updater.apply({
+        {1, "image/png"},
+        {3, std::nullopt},
+        {8, "application/pdf"},
+        {5, "text/plain"}
+    });
+    updater.save(index_file);
+    index = results::type_index{index_file};
+    EXPECT_EQ(index.types(), (std::vector<std::string_view>{"application/pdf", "image/png", "text/plain"}));
+    EXPECT_EQ(index.find("application/pdf"), std::vector<std::uint64_t>{8});
+    EXPECT_EQ(index.find("image/png"), std::vector<std::uint64_t>{1});
+    EXPECT_EQ(index.find("text/plain"), std::vector<std::uint64_t>{5});
+}
+
+TEST(magic_type_index_test, type_index_malformed_file)
+{
+    create_test_directory();
+    EXPECT_THROW(results::type_index{test_directory / "missing"}, magic_results_error);
+    results::type_index_builder builder;
+    builder.add(1, "text/plain");
+    builder.save(index_file);
+    std::filesystem::resize_file(index_file, std::filesystem::file_size(index_file) - 1);
+    EXPECT_THROW(results::type_index{index_file}, magic_results_error);
+    EXPECT_THROW(builder.save(test_directory / "missing" / "types.magicxxi"), magic_results_error);
+}
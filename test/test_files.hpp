@@ -0,0 +1,41 @@
+/* SPDX-FileCopyrightText: Copyright (c) 2024 Oğuz Toraman <oguz.toraman@tutanota.com> */
+/* SPDX-License-Identifier: LGPL-3.0-only */
+
+#ifndef TEST_FILES_HPP
+#define TEST_FILES_HPP
+
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+
+namespace recognition::test {
+
+/**
+ * @brief Recreate a test directory holding a test database and a test file, named test_database
+ *        and test_file, the test database describes the files starting with "MAGICXX".
+ *
+ * @param[in] test_directory    The path of the test directory, its previous contents are removed.
+ * @param[in] description       The description of the test file in the test database.
+ * @param[in] mime              The MIME type of the test file in the test database, default is none.
+ * @param[in] test_database     The path of the test database, default is test_directory / "test_database".
+ */
+inline void create_test_files(
+    const std::filesystem::path& test_directory,
+    std::string_view description,
+    std::string_view mime = {},
+    const std::filesystem::path& test_database = {})
+{
+    std::filesystem::remove_all(test_directory);
+    std::filesystem::create_directories(test_directory);
+    std::ofstream database{test_database.empty() ? test_directory / "test_database" : test_database, std::ios::trunc};
+    database << "0\tstring\tMAGICXX\t" << description << '\n';
+    if (!mime.empty()){
+        database << "!:mime\t" << mime << '\n';
+    }
+    std::ofstream file{test_directory / "test_file", std::ios::trunc};
+    file << "MAGICXX test file\n";
+}
+
+} /* namespace recognition::test */
+
+#endif /* TEST_FILES_HPP */